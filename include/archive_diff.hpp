@@ -0,0 +1,78 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "pak_parser.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace unpaker {
+
+enum class DiffStatus {
+    ADDED,
+    REMOVED,
+    MODIFIED,
+    MOVED,
+    UNCHANGED
+};
+
+struct DiffEntry {
+    DiffStatus status = DiffStatus::UNCHANGED;
+    std::string path;
+    // Previous path of a moved entry
+    std::string old_path;
+    EntryId old_id = INVALID_ENTRY_ID;
+    EntryId new_id = INVALID_ENTRY_ID;
+    uint32_t old_size = 0;
+    uint32_t new_size = 0;
+    uint32_t old_crc = 0;
+    uint32_t new_crc = 0;
+    // Metadata alone could not decide the status
+    bool ambiguous = false;
+    // The status was settled by comparing the entry data
+    bool confirmed = false;
+};
+
+struct DiffOptions {
+    // List unchanged entries too; they are always counted
+    bool include_unchanged = false;
+    // Extract and compare entries whose metadata is ambiguous
+    bool confirm_ambiguous = false;
+    uint32_t thread_count = 0;
+};
+
+struct ArchiveDiffResult {
+    std::vector<DiffEntry> entries;
+    uint32_t added = 0;
+    uint32_t removed = 0;
+    uint32_t modified = 0;
+    uint32_t moved = 0;
+    uint32_t unchanged = 0;
+    uint32_t ambiguous = 0;
+    uint32_t confirmed = 0;
+    double seconds = 0.0;
+};
+
+// Compares two parsed archives by path using only index metadata: size and, where the format
+// stores one, the CRC-32 of each entry. Paths match with the same case-folding rules as
+// PakParser::find(). An entry removed at one path and added at another with the same size and
+// CRC is reported as moved. Without CRCs, equal sizes are ambiguous; those entries are only
+// extracted when DiffOptions::confirm_ambiguous is set.
+class ArchiveDiff {
+public:
+    static ArchiveDiffResult compare(const PakParser& old_archive,
+                                     const PakParser& new_archive,
+                                     const DiffOptions& options = DiffOptions());
+
+    static void write_text(std::ostream& out, const ArchiveDiffResult& result);
+    // One JSON object per line, followed by a summary object
+    static void write_ndjson(std::ostream& out, const ArchiveDiffResult& result);
+
+    static const char* status_name(DiffStatus status);
+};
+
+} // namespace unpaker
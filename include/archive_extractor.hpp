@@ -0,0 +1,54 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "pak_parser.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+struct ExtractOptions {
+    // Write byte-identical entries once and hardlink the other copies to it
+    bool deduplicate = false;
+    uint32_t thread_count = 0;
+};
+
+struct ExtractReport {
+    uint32_t total_files = 0;
+    uint32_t written_files = 0;
+    // Duplicates served by a hardlink, and those copied because linking failed
+    uint32_t linked_files = 0;
+    uint32_t copied_files = 0;
+    uint32_t failed_files = 0;
+    uint64_t bytes_written = 0;
+    // Bytes not written thanks to hardlinks
+    uint64_t bytes_saved = 0;
+    // Bytes read only to confirm duplicates
+    uint64_t bytes_hashed = 0;
+    double seconds = 0.0;
+    std::vector<std::string> failures;
+};
+
+// Writes archive entries below an output directory, keeping their archive paths. With
+// deduplication, entries are grouped by size and CRC-32, candidates are confirmed with an MD5 of
+// their contents, and each distinct blob is written once.
+class ArchiveExtractor {
+public:
+    static ExtractReport extract_all(const PakParser& parser,
+                                     const fs::path& output_dir,
+                                     const ExtractOptions& options = ExtractOptions());
+
+    static ExtractReport extract(const PakParser& parser,
+                                 const std::vector<EntryId>& entries,
+                                 const fs::path& output_dir,
+                                 const ExtractOptions& options = ExtractOptions());
+};
+
+} // namespace unpaker
@@ -0,0 +1,161 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace unpaker {
+
+struct FileEntry;
+struct DirectoryEntry;
+
+using EntryId = uint32_t;
+using DirId = uint32_t;
+
+constexpr EntryId INVALID_ENTRY_ID = 0xFFFFFFFFu;
+constexpr DirId INVALID_DIR_ID = 0xFFFFFFFFu;
+constexpr DirId ROOT_DIR_ID = 0;
+
+// How an entry's bytes are kept; only plain entries can be read straight from their volume
+constexpr uint8_t STORAGE_PLAIN = 0;
+constexpr uint8_t STORAGE_COMPRESSED = 1;
+constexpr uint8_t STORAGE_ENCRYPTED = 2;
+
+// Location and checksum of one entry as reported by a parser
+struct EntryRecord {
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    uint32_t crc = 0;
+    uint32_t preload_offset = 0;
+    uint32_t preload_size = 0;
+    uint16_t archive_index = 0;
+    uint8_t storage = STORAGE_PLAIN;
+};
+
+// Flat struct-of-arrays index of a parsed archive. Every column is a contiguous array indexed
+// by EntryId or DirId, names live in one string pool, and directories are ranges: the files of
+// a directory occupy consecutive EntryIds and its subdirectories consecutive DirIds. An entry
+// costs 37 bytes plus its name.
+class ArchiveIndex {
+public:
+    ArchiveIndex();
+
+    size_t entry_count() const { return offsets.size(); }
+    size_t directory_count() const { return dir_parents.size(); }
+    bool empty() const { return offsets.empty(); }
+
+    std::string_view name(EntryId id) const { return pool_view(name_offsets[id], name_lengths[id]); }
+    uint64_t offset(EntryId id) const { return offsets[id]; }
+    uint32_t size(EntryId id) const { return sizes[id]; }
+    uint32_t crc(EntryId id) const { return crcs[id]; }
+    uint32_t preload_offset(EntryId id) const { return preload_offsets[id]; }
+    uint32_t preload_size(EntryId id) const { return preload_sizes[id]; }
+    uint16_t archive_index(EntryId id) const { return archive_indices[id]; }
+    uint8_t storage(EntryId id) const { return storages[id]; }
+    DirId directory_of(EntryId id) const { return entry_dirs[id]; }
+    EntryRecord record(EntryId id) const;
+    std::string path(EntryId id) const;
+
+    std::string_view directory_name(DirId id) const { return pool_view(dir_name_offsets[id], dir_name_lengths[id]); }
+    DirId directory_parent(DirId id) const { return dir_parents[id]; }
+    EntryId first_file(DirId id) const { return dir_first_files[id]; }
+    uint32_t file_count(DirId id) const { return dir_file_counts[id]; }
+    DirId first_subdirectory(DirId id) const { return dir_first_children[id]; }
+    uint32_t subdirectory_count(DirId id) const { return dir_child_counts[id]; }
+    std::string directory_path(DirId id) const;
+
+    // Columns for linear scans
+    const std::vector<uint64_t>& offset_column() const { return offsets; }
+    const std::vector<uint32_t>& size_column() const { return sizes; }
+    const std::vector<uint32_t>& crc_column() const { return crcs; }
+    const std::vector<uint16_t>& archive_index_column() const { return archive_indices; }
+
+    // Compatibility adapter for code written against the FileEntry / DirectoryEntry tree
+    std::shared_ptr<FileEntry> make_file_entry(EntryId id) const;
+    // Same, with the path of the entry's directory already known
+    std::shared_ptr<FileEntry> make_file_entry(EntryId id, const std::string& dir_path) const;
+    std::shared_ptr<DirectoryEntry> build_tree(const std::string& root_name) const;
+
+    size_t memory_usage() const;
+
+    void serialize(std::vector<uint8_t>& out) const;
+    bool deserialize(const uint8_t* data, size_t size);
+
+private:
+    friend class ArchiveIndexBuilder;
+
+    std::string_view pool_view(uint32_t offset, uint16_t length) const {
+        return std::string_view(names.data() + offset, length);
+    }
+
+    bool is_consistent() const;
+
+    // Entry columns
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> crcs;
+    std::vector<uint32_t> preload_offsets;
+    std::vector<uint32_t> preload_sizes;
+    std::vector<uint16_t> archive_indices;
+    std::vector<uint8_t> storages;
+    std::vector<uint32_t> name_offsets;
+    std::vector<uint16_t> name_lengths;
+    std::vector<DirId> entry_dirs;
+
+    // Directory columns; ROOT_DIR_ID is the archive root and has an empty name
+    std::vector<uint32_t> dir_name_offsets;
+    std::vector<uint16_t> dir_name_lengths;
+    std::vector<DirId> dir_parents;
+    std::vector<DirId> dir_first_children;
+    std::vector<uint32_t> dir_child_counts;
+    std::vector<EntryId> dir_first_files;
+    std::vector<uint32_t> dir_file_counts;
+
+    std::string names;
+};
+
+// Collects entries in parser order and lays them out as an ArchiveIndex. Directories are
+// resolved through one hash table keyed by (parent, name) and runs of entries in the same
+// directory skip the lookup, so building is linear in total path length and allocates only
+// as the columns grow.
+class ArchiveIndexBuilder {
+public:
+    ArchiveIndexBuilder();
+
+    void reserve(size_t entries);
+
+    // path is split at its last '/' or '\\' into directory and name
+    void add(std::string_view path, const EntryRecord& record);
+
+    // Adds "<stem>.<extension>" (or just "<stem>" for an empty extension) under dir_path
+    // without building the joined name first
+    void add(std::string_view dir_path, std::string_view stem, std::string_view extension, const EntryRecord& record);
+
+    size_t size() const { return staged.offsets.size(); }
+
+    // Orders directories breadth-first and entries by directory; leaves the builder empty
+    ArchiveIndex finish();
+
+private:
+    DirId resolve(std::string_view dir_path);
+    DirId child(DirId parent, std::string_view name);
+    uint32_t append_name(std::string_view text);
+    void push_record(DirId dir, uint32_t name_offset, size_t name_length, const EntryRecord& record);
+
+    static uint64_t child_key(DirId parent, std::string_view name);
+
+    ArchiveIndex staged;
+    std::unordered_multimap<uint64_t, DirId> children;
+    std::string last_dir_path;
+    DirId last_dir = INVALID_DIR_ID;
+};
+
+} // namespace unpaker
@@ -0,0 +1,109 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "pak_parser.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+using MountId = uint32_t;
+constexpr MountId INVALID_MOUNT_ID = 0xFFFFFFFFu;
+
+struct MountInfo {
+    fs::path path;
+    int32_t priority = 0;
+    bool is_directory = false;
+    uint32_t file_count = 0;
+    // Files of this mount that currently win their path
+    uint32_t visible_count = 0;
+};
+
+// Where a merged path resolves: an EntryId for an archive mount, or the index of a loose file
+// for a directory mount
+struct ResolvedFile {
+    MountId mount = INVALID_MOUNT_ID;
+    uint32_t entry = INVALID_ENTRY_ID;
+
+    bool found() const { return mount != INVALID_MOUNT_ID; }
+};
+
+// Several archives and loose directories seen as one file system, the way a Source game walks
+// its search paths. Each path resolves to the mount with the highest priority; on a tie the
+// mount added last wins, and within one archive the first of two folded duplicates is kept, as
+// in PakParser::find(). Paths match with the same rules as PathLookup.
+//
+// Mounting merges only the new source into the existing index. Lookups and reads may run
+// concurrently with each other, but not with a mount.
+class ArchiveSet {
+public:
+    // Parses the archive; INVALID_MOUNT_ID if it cannot be read
+    MountId mount_archive(const fs::path& path, int32_t priority = 0);
+    MountId mount_archive(std::shared_ptr<const PakParser> archive, const fs::path& path, int32_t priority = 0);
+    // Snapshots the regular files below directory; later changes on disk are not picked up
+    MountId mount_directory(const fs::path& directory, int32_t priority = 0);
+
+    size_t mount_count() const { return mounts.size(); }
+    const MountInfo& mount_info(MountId id) const { return mounts[id]->info; }
+    // Null for directory mounts
+    std::shared_ptr<const PakParser> archive(MountId id) const { return mounts[id]->archive; }
+
+    // Distinct paths across all mounts
+    size_t file_count() const { return visible_files; }
+    // Paths hidden by a mount that won them
+    size_t shadowed_count() const { return shadowed_files; }
+
+    ResolvedFile resolve(std::string_view path) const;
+    bool contains(std::string_view path) const { return resolve(path).found(); }
+
+    std::string path(const ResolvedFile& file) const;
+    uint64_t size(const ResolvedFile& file) const;
+
+    bool extract(std::string_view path, std::vector<uint8_t>& data) const;
+    bool extract(const ResolvedFile& file, std::vector<uint8_t>& data) const;
+    EntryStream open(std::string_view path) const;
+    EntryStream open(const ResolvedFile& file) const;
+
+    // Visits every winning file once, in no particular order
+    void for_each(const std::function<void(const ResolvedFile& file)>& visit) const;
+
+private:
+    struct LooseFile {
+        std::string path;
+        uint64_t size;
+    };
+
+    struct Mount {
+        MountInfo info;
+        std::shared_ptr<const PakParser> archive;
+        std::vector<LooseFile> loose_files;
+    };
+
+    struct Slot {
+        uint64_t hash;
+        ResolvedFile file;
+    };
+
+    MountId add_mount(std::unique_ptr<Mount> mount, const std::vector<uint64_t>& hashes);
+    void insert(uint64_t hash, const ResolvedFile& file);
+    void reserve(size_t count);
+    bool matches(const ResolvedFile& file, std::string_view path) const;
+
+    std::vector<std::unique_ptr<Mount>> mounts;
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t visible_files = 0;
+    size_t shadowed_files = 0;
+};
+
+} // namespace unpaker
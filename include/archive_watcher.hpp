@@ -0,0 +1,114 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "pak_parser.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+struct WatchOptions {
+    // How long the files must stay unchanged before they are parsed again; patchers rewrite the
+    // directory file and the data volumes one after another
+    uint32_t settle_ms = 1000;
+    // Interval between checks of the files; change notifications only make the check come sooner
+    uint32_t poll_ms = 2000;
+    uint32_t thread_count = 0;
+    bool index_cache = true;
+};
+
+// Keeps a parsed archive in step with the files on disk. A background thread watches the
+// directory holding the archive (inotify on Linux, change notifications on Windows, plain polling
+// where neither is available), and when the archive or one of its data volumes changes it parses
+// the new version and publishes it as the current snapshot. Readers take a snapshot and keep
+// using it for as long as they hold it, so work that started on the old version finishes there.
+class ArchiveWatcher {
+public:
+    using ReloadCallback = std::function<void(const std::shared_ptr<const PakParser>&)>;
+
+    explicit ArchiveWatcher(const fs::path& archive_path, const WatchOptions& options = WatchOptions());
+    ~ArchiveWatcher();
+
+    ArchiveWatcher(const ArchiveWatcher&) = delete;
+    ArchiveWatcher& operator=(const ArchiveWatcher&) = delete;
+
+    // Parses the archive and starts watching it. on_reload runs on the watcher thread each time a
+    // changed archive has been parsed and published.
+    bool start(ReloadCallback on_reload = nullptr);
+    void stop();
+
+    // The newest published archive, without taking a lock; null before start() succeeds
+    std::shared_ptr<const PakParser> snapshot() const;
+    // Number of snapshots published so far, the first one included
+    uint64_t generation() const { return published.load(); }
+    bool using_notifications() const { return notifications; }
+
+    // The archive plus its numbered data volumes (name_dir.vpk -> name_000.vpk, ...)
+    static std::vector<fs::path> watched_files(const fs::path& archive_path);
+
+private:
+    struct FileStamp {
+        fs::path path;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+
+        bool operator==(const FileStamp& other) const {
+            return path == other.path && size == other.size && mtime == other.mtime;
+        }
+    };
+    using Stamps = std::vector<FileStamp>;
+
+    // One published snapshot and the readers currently copying it out
+    struct Slot {
+        std::shared_ptr<const PakParser> parser;
+        std::atomic<uint32_t> readers{0};
+    };
+
+    Stamps take_stamps() const;
+    std::shared_ptr<const PakParser> parse() const;
+    void publish(std::shared_ptr<const PakParser> parser);
+    void watch_loop(Stamps known);
+
+    bool open_notifications();
+    void close_notifications();
+    // Returns once the directory reports a change, timeout_ms passes or stop() is called
+    void wait_for_change(uint32_t timeout_ms);
+    // Sleeps for timeout_ms unless stop() is called first; false when stopping
+    bool sleep_for(uint32_t timeout_ms);
+
+    fs::path archive_path;
+    WatchOptions options;
+    ReloadCallback on_reload;
+
+    // Readers pin the current slot and copy its pointer; the watcher fills the other slot and
+    // swaps, then waits for the pins on the old one to drain before releasing its parser
+    Slot slots[2];
+    std::atomic<Slot*> current{nullptr};
+    std::atomic<uint64_t> published{0};
+
+    std::thread worker;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> notifications{false};
+
+#ifdef _WIN32
+    void* change_handle = nullptr;
+#else
+    int inotify_fd = -1;
+#endif
+};
+
+} // namespace unpaker
@@ -0,0 +1,21 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstdint>
+
+namespace unpaker {
+
+// ASCII case folding used for archive paths and search text. Only A-Z change, so UTF-8 and
+// other bytes above 0x7f compare as stored.
+constexpr uint8_t fold_ascii(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c + ('a' - 'A')) : c;
+}
+
+constexpr char fold_ascii(char c) {
+    return static_cast<char>(fold_ascii(static_cast<uint8_t>(c)));
+}
+
+} // namespace unpaker
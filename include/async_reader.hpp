@@ -0,0 +1,67 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "random_access_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace unpaker {
+
+class ThreadPool;
+
+// One vectored read of a batch: the range starting at offset is scattered across slices
+struct ReadRequest {
+    const RandomAccessFile* file = nullptr;
+    uint64_t offset = 0;
+    const IoSlice* slices = nullptr;
+    size_t slice_count = 0;
+    // Filled in by AsyncReader::read_all()
+    size_t bytes_read = 0;
+};
+
+// Completes batches of independent reads with many of them in flight at once. With io_uring
+// (built with UNPAKER_ENABLE_IO_URING on Linux) the calling thread keeps up to queue_depth reads
+// queued in the kernel; elsewhere, or when the kernel refuses a ring, the batch is spread over
+// a thread pool issuing positional reads.
+class AsyncReader {
+public:
+    enum class Backend {
+        IO_URING,
+        THREAD_POOL
+    };
+
+    explicit AsyncReader(uint32_t queue_depth = 256, uint32_t thread_count = 0);
+    ~AsyncReader();
+
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+
+    // Returns once every request has completed; requests finish in no particular order
+    void read_all(std::vector<ReadRequest>& requests);
+
+    Backend backend() const { return backend_; }
+    const char* backend_name() const;
+
+private:
+#ifdef UNPAKER_IO_URING
+    struct Ring;
+
+    bool setup_ring(uint32_t entries);
+    void read_all_ring(std::vector<ReadRequest>& requests);
+
+    Ring* ring_ = nullptr;
+#endif
+
+    void read_all_pool(std::vector<ReadRequest>& requests);
+
+    Backend backend_ = Backend::THREAD_POOL;
+    uint32_t thread_count_;
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+} // namespace unpaker
@@ -0,0 +1,61 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "pak_parser.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace unpaker {
+
+struct SearchOptions {
+    // A line matches when it contains any of these strings
+    std::vector<std::string> literals;
+    // Optional ECMAScript regex. With literals it only filters the lines they found; on its own
+    // every line is tested, which is far slower.
+    std::string regex;
+    bool ignore_case = false;
+    // Matching lines reported per entry; 0 for all of them
+    uint32_t max_matches_per_entry = 0;
+    // Bytes of the line kept on each side of the hit
+    uint32_t context_bytes = 80;
+    uint32_t thread_count = 0;
+};
+
+struct SearchMatch {
+    EntryId entry = INVALID_ENTRY_ID;
+    std::string path;
+    // Position of the hit within the entry, and the 1-based line holding it
+    uint64_t offset = 0;
+    uint32_t line = 0;
+    std::string context;
+};
+
+struct SearchResult {
+    std::vector<SearchMatch> matches;
+    uint32_t entries_searched = 0;
+    uint32_t entries_matched = 0;
+    uint32_t entries_failed = 0;
+    uint64_t bytes_searched = 0;
+    double seconds = 0.0;
+};
+
+// Searches entry contents without extracting them: each entry is streamed from its data volume
+// through a fixed buffer, aligned to line boundaries, and scanned for the literals 16 bytes at a
+// time where SSE2 is available. Entries are grouped by volume and read in offset order, and the
+// groups are searched in parallel. Matches come back ordered by entry and offset.
+class ContentSearch {
+public:
+    static SearchResult search(const PakParser& parser, const SearchOptions& options);
+    static SearchResult search(const PakParser& parser, const std::vector<EntryId>& entries,
+                               const SearchOptions& options);
+
+    // path:line:offset: context, one match per line
+    static void write_text(std::ostream& out, const SearchResult& result);
+};
+
+} // namespace unpaker
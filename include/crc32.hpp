@@ -0,0 +1,19 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace unpaker {
+
+// CRC-32 (IEEE 802.3, as used by zlib and VPK). Pass a previous result as crc to continue a
+// running checksum over consecutive buffers.
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+// Name of the kernel selected for this CPU, for diagnostics
+const char* crc32_implementation();
+
+} // namespace unpaker
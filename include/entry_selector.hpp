@@ -0,0 +1,58 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "archive_index.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace unpaker {
+
+// Selects archive entries by path with a list of patterns compiled once and reused. A pattern
+// is a glob unless it starts with "re:", in which case the rest is an ECMAScript regex searched
+// anywhere in the path. A leading '!' turns a pattern into an exclusion.
+//
+// Globs: '*' and '?' stay within one path component, "**" crosses components, "**/" also
+// matches no directory at all, and [abc], [a-z], [!a] are character classes. A glob without
+// '/' is matched against the file name alone, so "*.vtf" finds textures in every directory.
+// Matching ignores ASCII case and treats '\\' as '/', as PathLookup does.
+//
+// As in .gitignore, the last pattern that matches a path decides. Paths matching no pattern are
+// selected only when the first pattern is an exclusion.
+class EntrySelector {
+public:
+    EntrySelector();
+    ~EntrySelector();
+    EntrySelector(EntrySelector&&) noexcept;
+    EntrySelector& operator=(EntrySelector&&) noexcept;
+
+    // Returns false for a malformed pattern, which is not added
+    bool add(std::string_view pattern);
+    bool empty() const { return patterns.empty(); }
+    size_t pattern_count() const { return patterns.size(); }
+
+    bool matches(std::string_view path) const;
+
+    // Matching entries in EntryId order. Directories whose path rules a pattern out are skipped
+    // without looking at their files.
+    std::vector<EntryId> select(const ArchiveIndex& index, uint32_t thread_count = 0) const;
+
+    // Reorders entries by data volume and offset, the order in which extraction reads them
+    static void sort_for_extraction(const ArchiveIndex& index, std::vector<EntryId>& entries);
+
+private:
+    struct Pattern;
+
+    // Applies the active patterns to an entry; path holds its directory, ending at dir_length
+    bool decide(const std::vector<const Pattern*>& active, std::string& path, size_t dir_length,
+                std::string_view name) const;
+
+    std::vector<std::unique_ptr<Pattern>> patterns;
+};
+
+} // namespace unpaker
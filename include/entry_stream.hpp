@@ -0,0 +1,72 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "random_access_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace unpaker {
+
+// One stored piece of an entry: a range of an open file, or bytes already in memory such as a
+// mapped directory file. Owners keep the source alive for as long as the stream exists.
+struct EntrySegment {
+    std::shared_ptr<const RandomAccessFile> file;
+    uint64_t offset = 0;
+
+    const uint8_t* memory = nullptr;
+    std::shared_ptr<const void> memory_owner;
+
+    uint64_t length = 0;
+
+    static EntrySegment from_file(std::shared_ptr<const RandomAccessFile> file, uint64_t offset, uint64_t length);
+    static EntrySegment from_memory(std::shared_ptr<const void> owner, const uint8_t* data, uint64_t length);
+};
+
+// Receives consecutive pieces of an entry; returning false stops the copy
+using ChunkCallback = std::function<bool(const uint8_t* data, size_t length)>;
+
+// Reads an archive entry on demand instead of materializing it, so an entry of any size can be
+// hashed, decoded or written out with a fixed-size buffer. A default-constructed stream is closed.
+class EntryStream {
+public:
+    EntryStream() = default;
+    explicit EntryStream(std::vector<EntrySegment> segments);
+
+    bool is_open() const { return open_; }
+    // A read came back short; the stream stays usable after a seek
+    bool failed() const { return failed_; }
+
+    uint64_t size() const { return size_; }
+    uint64_t tell() const { return position_; }
+    bool eof() const { return position_ >= size_; }
+
+    bool seek(uint64_t position);
+
+    // Reads up to length bytes from the current position and returns the count read, which is
+    // short only at the end of the entry or on error
+    size_t read(void* buffer, size_t length);
+
+    // Hands the rest of the entry to on_chunk in pieces of at most chunk_size bytes. Returns true
+    // once the end is reached; false on a read error or when on_chunk stops early.
+    bool copy_to(const ChunkCallback& on_chunk, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+private:
+    std::vector<EntrySegment> segments_;
+    // Entry position at which each segment starts
+    std::vector<uint64_t> starts_;
+    uint64_t size_ = 0;
+    uint64_t position_ = 0;
+    size_t segment_ = 0;
+    bool open_ = false;
+    bool failed_ = false;
+};
+
+} // namespace unpaker
@@ -0,0 +1,42 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "random_access_file.hpp"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace unpaker {
+
+// Bounded LRU cache of open read handles keyed by path. Handles are shared, so a handle evicted
+// while another thread is still reading from it stays open until that read finishes.
+class FileHandlePool {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 32;
+
+    explicit FileHandlePool(size_t capacity = DEFAULT_CAPACITY);
+
+    std::shared_ptr<const RandomAccessFile> acquire(const fs::path& path);
+
+    // Evicts down to the new capacity right away; 0 means handles are never evicted
+    void set_capacity(size_t capacity);
+    void clear();
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<const RandomAccessFile>>>;
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    LruList lru_;
+    std::unordered_map<std::string, LruList::iterator> handles_;
+};
+
+} // namespace unpaker
@@ -18,22 +18,55 @@ struct ValidationResult {
     uint32_t invalid_entries = 0;
     uint32_t invalid_offsets = 0;
     uint32_t zero_size_files = 0;
+    bool section_checksums_present = false;
+    uint32_t section_chunks_checked = 0;
+    uint32_t section_chunks_failed = 0;
     std::vector<std::string> error_messages;
     std::vector<std::string> warnings;
 };
 
+struct ChecksumMismatch {
+    std::string path;
+    uint32_t expected = 0;
+    uint32_t actual = 0;
+};
+
+struct IntegrityReport {
+    bool supported = true;
+    uint32_t total_files = 0;
+    uint32_t verified_files = 0;
+    uint64_t bytes_verified = 0;
+    double seconds = 0.0;
+    std::vector<ChecksumMismatch> mismatches;
+    std::vector<std::string> unreadable_files;
+
+    bool passed() const { return supported && mismatches.empty() && unreadable_files.empty(); }
+    double throughput_gbps() const { return seconds > 0.0 ? bytes_verified / seconds / 1e9 : 0.0; }
+};
+
 class FileValidator {
 public:
     static ValidationResult validateArchive(const std::shared_ptr<DirectoryEntry>& root,
                                                                                        uint64_t archive_size);
 
+    // Same checks against the flat index; duplicates are found per directory without building paths
+    static ValidationResult validateArchive(const ArchiveIndex& index, uint64_t archive_size);
+
     static uint32_t checkDuplicates(const std::vector<std::shared_ptr<FileEntry>>& files,
                                     std::vector<std::string>& duplicates);
 
+    // Reads every entry and compares its data with the CRC-32 stored in the archive
+    static IntegrityReport verifyChecksums(const PakParser& parser, uint32_t thread_count = 0);
+
+    // Checks the archive-level checksum sections; failures are reported as validation errors
+    static ValidationResult verifySectionChecksums(const PakParser& parser);
+
     static bool validateFileEntry(const std::shared_ptr<FileEntry>& entry,
                                                                   uint64_t archive_size);
 
 private:
+    static bool validatePath(const std::string& path);
+
     static void collectAllFiles(const std::shared_ptr<DirectoryEntry>& dir,
                                                                std::vector<std::shared_ptr<FileEntry>>& files);
 };
@@ -12,6 +12,7 @@
 #define NOMINMAX
 #endif
 #include <windows.h>
+#include <commctrl.h>
 #ifdef ERROR
 #undef ERROR
 #endif
@@ -63,11 +64,12 @@ private:
 
     void create_controls();
     void populate_tree_view();
+    void populate_directory_item(HTREEITEM item, DirId dir);
     void display_archive_info();
     void preview_file(const std::shared_ptr<FileEntry>& file);
     void handle_open_file();
+    void handle_verify_integrity();
     void set_status_text(const std::string& text);
-    std::shared_ptr<FileEntry> find_file_in_tree(const std::shared_ptr<DirectoryEntry>& dir, const std::string& filename);
     void check_for_updates();
 
     friend LRESULT CALLBACK gui_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
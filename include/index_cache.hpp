@@ -0,0 +1,48 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "archive_index.hpp"
+#include <cstdint>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+// Persistent binary snapshot of a parsed archive. Each cache file is keyed by the archive's
+// absolute path, size and modification time; a warm open maps the cache file once and copies
+// the index columns back without touching the archive parser.
+class IndexCache {
+public:
+    IndexCache();
+    explicit IndexCache(const fs::path& cache_dir);
+
+    bool load(const fs::path& archive_path,
+              ArchiveIndex& index,
+              uint32_t& file_count,
+              uint32_t& format) const;
+
+    bool store(const fs::path& archive_path,
+               const ArchiveIndex& index,
+               uint32_t file_count,
+               uint32_t format) const;
+
+    bool invalidate(const fs::path& archive_path) const;
+
+    fs::path get_cache_file(const fs::path& archive_path) const;
+    const fs::path& get_cache_dir() const;
+
+    static fs::path default_cache_dir();
+
+    // A name beside target that no other process or thread writing target will pick; files are
+    // written there first and renamed over target so readers never see a partial file
+    static fs::path temp_file_for(const fs::path& target);
+
+private:
+    fs::path cache_dir;
+};
+
+} // namespace unpaker
@@ -0,0 +1,46 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "archive_index.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace unpaker {
+
+// DirectoryEntry view of an ArchiveIndex that is materialized one directory at a time. The
+// index already holds each directory as a span of entries, so opening a directory only turns
+// its own span into FileEntry objects and its subdirectories into unpopulated shells. Nothing
+// below a directory is allocated until that directory is requested itself.
+class LazyDirectoryTree {
+public:
+    // The index must outlive the tree
+    LazyDirectoryTree(const ArchiveIndex& index, const std::string& root_name);
+
+    LazyDirectoryTree(const LazyDirectoryTree&) = delete;
+    LazyDirectoryTree& operator=(const LazyDirectoryTree&) = delete;
+
+    // Returns the directory with its files and immediate subdirectories filled in, populating it
+    // on first use. Safe to call from several threads.
+    std::shared_ptr<DirectoryEntry> get(DirId id) const;
+
+    size_t materialized_directories() const { return materialized.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        std::once_flag populated;
+        std::shared_ptr<DirectoryEntry> entry;
+    };
+
+    void populate(DirId id) const;
+
+    const ArchiveIndex& index;
+    std::unique_ptr<Node[]> nodes;
+    mutable std::atomic<size_t> materialized{0};
+};
+
+} // namespace unpaker
@@ -0,0 +1,49 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+// Read-only memory mapping of a whole file. Pages are only faulted in when touched,
+// so mapping a multi-GB archive to walk its header and tree is cheap. read() loads a private
+// copy instead, for files that may be truncated in place while data() is still in use.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const fs::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const fs::path& path);
+    bool read(const fs::path& path);
+    void close();
+
+    bool is_open() const { return opened_; }
+    const uint8_t* data() const { return data_; }
+    uint64_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+    bool opened_ = false;
+    std::vector<uint8_t> copy_;
+
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace unpaker
@@ -0,0 +1,36 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace unpaker {
+
+using Md5Digest = std::array<uint8_t, 16>;
+
+// Incremental MD5 (RFC 1321), used to check the checksum sections of VPK v2 archives
+class Md5 {
+public:
+    Md5();
+
+    void update(const void* data, size_t length);
+    Md5Digest finalize();
+
+    static Md5Digest digest(const void* data, size_t length);
+    static std::string to_hex(const Md5Digest& digest);
+
+private:
+    void transform(const uint8_t* block);
+
+    uint32_t state[4];
+    uint64_t total_length = 0;
+    uint8_t buffer[64];
+    size_t buffered = 0;
+};
+
+} // namespace unpaker
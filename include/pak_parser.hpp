@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include "archive_index.hpp"
+#include "path_lookup.hpp"
+#include "entry_stream.hpp"
 #include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 #include <filesystem>
+#include <functional>
+#include <mutex>
 
 namespace fs = std::filesystem;
 
@@ -16,13 +21,33 @@ namespace unpaker {
 
 struct FileEntry {
     std::string name;
-    uint32_t offset;
+    uint64_t offset;
     uint32_t size;
     std::string path;
     bool is_directory;
+    // Data volume holding the entry, in formats that split an archive across files
     uint32_t archive_index;
+    uint8_t storage = STORAGE_PLAIN;
+    uint32_t crc = 0;
+    // Leading bytes stored inline in the directory file rather than the data volume
+    uint32_t preload_offset = 0;
+    uint32_t preload_size = 0;
 };
 
+// Outcome of checking archive-level checksums such as the MD5 sections of VPK v2 files
+struct SectionChecksumReport {
+    bool present = false;
+    uint32_t chunks_checked = 0;
+    uint32_t chunks_failed = 0;
+    uint64_t bytes_hashed = 0;
+    std::vector<std::string> failures;
+};
+
+// Receives each entry of a batch extraction; data may be moved out by the callee
+using ExtractCallback = std::function<void(const std::shared_ptr<FileEntry>& file,
+                                           bool success,
+                                           std::vector<uint8_t>& data)>;
+
 struct DirectoryEntry {
     std::string name;
     std::vector<std::shared_ptr<FileEntry>> files;
@@ -35,18 +60,54 @@ namespace parsers {
     class BaseParser;
 }
 
+class LazyDirectoryTree;
+
 class PakParser {
 public:
     explicit PakParser(const fs::path& pak_path);
     ~PakParser();
 
     bool parse();
+    const ArchiveIndex& get_index() const;
+    // Resolves a full entry path, ignoring case and separator style; INVALID_ENTRY_ID if absent
+    EntryId find(std::string_view path) const;
+    const std::vector<PathCollision>& get_path_collisions() const;
+    // Tree view of the index, built in full on first use
     std::shared_ptr<DirectoryEntry> get_root() const;
+    // One directory of a lazily materialized tree: its files and subdirectory shells are created
+    // on first access, and a shell is filled in when it is requested in turn
+    std::shared_ptr<DirectoryEntry> get_directory(DirId id) const;
+    std::shared_ptr<DirectoryEntry> get_directory(std::string_view path) const;
+    DirId find_directory(std::string_view path) const;
     bool is_valid() const;
     std::string get_format_info() const;
     uint32_t get_file_count() const;
     uint64_t get_archive_size() const;
+    const fs::path& get_archive_path() const;
     bool extract_file(const std::shared_ptr<FileEntry>& file, std::vector<uint8_t>& data) const;
+    bool extract_entry(EntryId id, std::vector<uint8_t>& data) const;
+    // Read into caller-owned memory of at least the entry's size, without allocating or
+    // zero-filling; bytes_read reports how much was actually read
+    bool extract_file(const std::shared_ptr<FileEntry>& file, uint8_t* buffer, size_t capacity,
+                      size_t& bytes_read) const;
+    bool extract_entry(EntryId id, uint8_t* buffer, size_t capacity, size_t& bytes_read) const;
+    // Callers that already run batches on several threads pass read_threads = 1 so each batch
+    // reads on the thread that asked for it instead of starting a pool of its own
+    size_t extract_files(const std::vector<std::shared_ptr<FileEntry>>& files,
+                         const ExtractCallback& on_extracted,
+                         uint32_t read_threads = 0) const;
+    // Reads an entry in pieces rather than all at once; the stream is closed on failure
+    EntryStream open_file(const std::shared_ptr<FileEntry>& file) const;
+    EntryStream open_entry(EntryId id) const;
+
+    bool has_entry_checksums() const;
+    SectionChecksumReport verify_section_checksums() const;
+
+    void set_index_cache_enabled(bool enabled);
+    bool loaded_from_cache() const;
+    void set_thread_count(uint32_t count);
+    // See BaseParser::set_pin_files; takes effect at the next parse()
+    void set_pin_files(bool enabled);
 
 private:
     enum class PakFormat {
@@ -58,14 +119,24 @@ private:
     };
 
     fs::path archive_path;
-    std::shared_ptr<DirectoryEntry> root_directory;
+    ArchiveIndex index;
+    PathLookup path_lookup;
+    mutable std::mutex root_mutex;
+    mutable std::shared_ptr<DirectoryEntry> root_directory;
+    std::unique_ptr<LazyDirectoryTree> lazy_tree;
     PakFormat detected_format;
     uint32_t file_count;
     uint64_t archive_size;
     std::shared_ptr<parsers::BaseParser> current_parser;
+    bool index_cache_enabled;
+    bool from_cache;
+    uint32_t thread_count;
+    bool pin_files;
 
     bool detect_format();
-    bool build_directory_tree();
+    bool load_cached_index();
+    void index_ready();
+    static std::shared_ptr<parsers::BaseParser> create_parser(PakFormat format);
 };
 
 }
@@ -5,8 +5,12 @@
 #pragma once
 
 #include "pak_parser.hpp"
+#include "entry_stream.hpp"
+#include "file_handle_pool.hpp"
 #include <memory>
 #include <filesystem>
+#include <vector>
+#include <iostream>
 
 namespace fs = std::filesystem;
 
@@ -16,8 +20,9 @@ class BaseParser {
 public:
     virtual ~BaseParser() = default;
 
+    // Adds every entry of the archive to index in the format's natural order
     virtual bool parse(const fs::path& archive_path,
-                                              std::shared_ptr<DirectoryEntry>& root,
+                                              ArchiveIndexBuilder& index,
                                               uint32_t& file_count) = 0;
 
     virtual bool detect(const fs::path& archive_path) = 0;
@@ -25,6 +30,92 @@ public:
     virtual bool extract_file(const fs::path& archive_path,
                                                          const std::shared_ptr<FileEntry>& file,
                                                          std::vector<uint8_t>& data) const = 0;
+
+    // Reads an entry into caller-owned memory, so hot loops can reuse one buffer or carve
+    // entries out of an arena; nothing is allocated or zero-filled. Fails without reading when
+    // capacity is smaller than the entry. bytes_read is set even on failure.
+    virtual bool extract_into(const fs::path& archive_path,
+                              const std::shared_ptr<FileEntry>& file,
+                              uint8_t* buffer,
+                              size_t capacity,
+                              size_t& bytes_read) const {
+        bytes_read = 0;
+        if (!file || capacity < file->size) {
+            return false;
+        }
+
+        auto handle = handle_pool.acquire(archive_path);
+        if (!handle) {
+            std::cerr << "[ERROR] Failed to open archive file: " << archive_path.string() << std::endl;
+            return false;
+        }
+        bytes_read = handle->read_at(file->offset, buffer, file->size);
+        return bytes_read == file->size;
+    }
+
+    // Extracts a batch of entries, reporting each through on_extracted. Formats that can
+    // reorder reads for locality override this; callback order is then unspecified.
+    // read_threads bounds the threads the batch may read with, 0 meaning the parser's own setting.
+    virtual size_t extract_files(const fs::path& archive_path,
+                                 const std::vector<std::shared_ptr<FileEntry>>& files,
+                                 const ExtractCallback& on_extracted,
+                                 uint32_t /*read_threads*/) const {
+        size_t extracted = 0;
+        std::vector<uint8_t> data;
+        for (const auto& file : files) {
+            data.clear();
+            bool success = file && extract_file(archive_path, file, data);
+            if (success) ++extracted;
+            if (on_extracted) on_extracted(file, success, data);
+        }
+        return extracted;
+    }
+
+    // Opens an entry for reading in pieces. The default suits formats that store each entry
+    // uncompressed as one range of the archive file.
+    virtual EntryStream open_entry(const fs::path& archive_path,
+                                   const std::shared_ptr<FileEntry>& file) const {
+        if (!file) {
+            return EntryStream();
+        }
+
+        auto handle = handle_pool.acquire(archive_path);
+        if (!handle) {
+            std::cerr << "[ERROR] Failed to open archive file: " << archive_path.string() << std::endl;
+            return EntryStream();
+        }
+        return EntryStream({EntrySegment::from_file(std::move(handle), file->offset, file->size)});
+    }
+
+    // Whether parsed entries carry a CRC-32 of their contents in FileEntry::crc
+    virtual bool provides_crc32() const { return false; }
+
+    // Checks checksums stored for the archive as a whole; report.present stays false when the
+    // format or this particular archive carries none
+    virtual SectionChecksumReport verify_section_checksums(const fs::path&) const {
+        return SectionChecksumReport();
+    }
+
+    // Worker threads a parser may use; 0 means one per hardware thread
+    void set_thread_count(uint32_t count) { thread_count = count; }
+    uint32_t get_thread_count() const { return thread_count; }
+
+    // Keep every file the archive is read from open for as long as the parser lives, and a copy
+    // instead of a mapping of any file it would map. Reads then keep seeing the versions that were
+    // parsed even after a patcher replaces, rewrites or truncates them on disk.
+    void set_pin_files(bool enabled) {
+        pin_files = enabled;
+        handle_pool.set_capacity(enabled ? 0 : FileHandlePool::DEFAULT_CAPACITY);
+    }
+
+    // Opens the files a pinned parser reads from, once the archive has been parsed
+    virtual void open_pinned_files(const fs::path& archive_path) const { handle_pool.acquire(archive_path); }
+
+protected:
+    uint32_t thread_count = 0;
+    bool pin_files = false;
+    // Read handles for the archive and, in multi-file formats, its data volumes
+    mutable FileHandlePool handle_pool;
 };
 
 } // namespace unpaker::parsers
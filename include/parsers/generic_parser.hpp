@@ -11,7 +11,7 @@ namespace unpaker::parsers {
 class GenericParser : public BaseParser {
 public:
     bool parse(const fs::path& archive_path,
-                              std::shared_ptr<DirectoryEntry>& root,
+                              ArchiveIndexBuilder& index,
                               uint32_t& file_count) override;
 
     bool detect(const fs::path& archive_path) override;
@@ -0,0 +1,53 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstdint>
+
+// On-disk constants of Unreal Engine 4/5 .pak files (FPakInfo footer and FPakEntry records)
+namespace unpaker::parsers::ue {
+
+constexpr uint32_t PAK_MAGIC = 0x5A6F12E1;
+
+constexpr uint32_t VERSION_INITIAL = 1;
+constexpr uint32_t VERSION_NO_TIMESTAMPS = 2;
+constexpr uint32_t VERSION_COMPRESSION_ENCRYPTION = 3;
+constexpr uint32_t VERSION_INDEX_ENCRYPTION = 4;
+constexpr uint32_t VERSION_RELATIVE_CHUNK_OFFSETS = 5;
+constexpr uint32_t VERSION_DELETE_RECORDS = 6;
+constexpr uint32_t VERSION_ENCRYPTION_KEY_GUID = 7;
+constexpr uint32_t VERSION_FNAME_BASED_COMPRESSION = 8;
+constexpr uint32_t VERSION_FROZEN_INDEX = 9;
+constexpr uint32_t VERSION_PATH_HASH_INDEX = 10;
+constexpr uint32_t VERSION_FNV64_BUG_FIX = 11;
+
+// Footer layout, back to front: compression method names (v8+), frozen-index flag (v9 only),
+// SHA-1 of the index, index size and offset, version, magic, encrypted-index flag (v4+) and
+// the encryption key GUID (v7+)
+constexpr uint32_t GUID_SIZE = 16;
+constexpr uint32_t HASH_SIZE = 20;
+constexpr uint32_t COMPRESSION_NAME_SIZE = 32;
+constexpr uint32_t FOOTER_SIZE_V3 = 44;
+constexpr uint32_t FOOTER_SIZE_V4 = 45;
+constexpr uint32_t FOOTER_SIZE_V7 = 61;
+// UE 4.22 wrote v8 with four compression names; later engines use five
+constexpr uint32_t FOOTER_SIZE_V8_422 = FOOTER_SIZE_V7 + 4 * COMPRESSION_NAME_SIZE;
+constexpr uint32_t FOOTER_SIZE_V8 = FOOTER_SIZE_V7 + 5 * COMPRESSION_NAME_SIZE;
+constexpr uint32_t FOOTER_SIZE_V9 = FOOTER_SIZE_V8 + 1;
+constexpr uint32_t MAX_FOOTER_SIZE = FOOTER_SIZE_V9;
+
+// Before v8 an entry names its compression with these flags instead of a method index
+constexpr uint32_t COMPRESS_NONE = 0x00;
+constexpr uint32_t COMPRESS_ZLIB = 0x01;
+constexpr uint32_t COMPRESS_GZIP = 0x02;
+constexpr uint32_t COMPRESS_CUSTOM = 0x04;
+
+constexpr uint8_t ENTRY_FLAG_ENCRYPTED = 0x01;
+constexpr uint8_t ENTRY_FLAG_DELETED = 0x02;
+
+// Compressed blocks of an encrypted entry are padded to the AES block size
+constexpr uint32_t AES_BLOCK_SIZE = 16;
+
+} // namespace unpaker::parsers::ue
@@ -5,13 +5,32 @@
 #pragma once
 
 #include "base_parser.hpp"
+#include <string>
 
 namespace unpaker::parsers {
 
+// Unreal Engine 4/5 .pak files. The versioned footer at the end of the file gives the position
+// of the index, which is read in one piece and decoded: a flat list of FPakEntry records up to
+// v9, and from v10 on a directory index naming bit-packed entries. Entries are recorded at the
+// start of their data, past the FPakEntry header stored in front of it, so uncompressed and
+// unencrypted entries read straight from the archive. Files without a footer fall back to the
+// older headerless layout.
 class UEParser : public BaseParser {
 public:
+    struct PakInfo {
+        uint32_t version = 0;
+        uint32_t footer_size = 0;
+        uint64_t index_offset = 0;
+        uint64_t index_size = 0;
+        bool encrypted_index = false;
+        bool frozen_index = false;
+        // UE 4.22 wrote v8 entries with a one-byte compression method index
+        bool byte_compression_index = false;
+        std::vector<std::string> compression_methods;
+    };
+
     bool parse(const fs::path& archive_path,
-                              std::shared_ptr<DirectoryEntry>& root,
+                              ArchiveIndexBuilder& index,
                               uint32_t& file_count) override;
 
     bool detect(const fs::path& archive_path) override;
@@ -20,7 +39,35 @@ public:
                                          const std::shared_ptr<FileEntry>& file,
                                          std::vector<uint8_t>& data) const override;
 
+    // Compressed and encrypted entries are listed but refused here
+    bool extract_into(const fs::path& archive_path,
+                      const std::shared_ptr<FileEntry>& file,
+                      uint8_t* buffer,
+                      size_t capacity,
+                      size_t& bytes_read) const override;
+
+    EntryStream open_entry(const fs::path& archive_path,
+                           const std::shared_ptr<FileEntry>& file) const override;
+
+    // Matches every known footer layout (v3 to v11) against the end of the file
+    static bool read_pak_info(const RandomAccessFile& file, PakInfo& info);
+
 private:
+    bool parse_entry_list(const PakInfo& info,
+                          const std::vector<uint8_t>& primary_index,
+                          ArchiveIndexBuilder& index,
+                          uint32_t& file_count);
+
+    bool parse_path_hash_index(const RandomAccessFile& file,
+                               const PakInfo& info,
+                               const std::vector<uint8_t>& primary_index,
+                               ArchiveIndexBuilder& index,
+                               uint32_t& file_count);
+
+    bool parse_headerless(const fs::path& archive_path,
+                          ArchiveIndexBuilder& index,
+                          uint32_t& file_count);
+
     std::string read_cstring(std::FILE* file, size_t offset);
 };
 
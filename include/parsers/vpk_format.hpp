@@ -0,0 +1,44 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// On-disk constants of the Source engine VPK format, shared by VpkParser and VpkWriter
+namespace unpaker::parsers::vpk {
+
+constexpr uint32_t SIGNATURE = 0x55aa1234;
+constexpr uint32_t DIR_FORMAT_SIGNATURE = 0x465456;
+
+constexpr uint32_t V1_HEADER_SIZE = 12;
+constexpr uint32_t V2_HEADER_SIZE = 28;
+
+// crc u32, preload u16, archive index u16, offset u32, length u32, terminator u16
+constexpr uint32_t ENTRY_METADATA_SIZE = 18;
+constexpr uint16_t ENTRY_TERMINATOR = 0xffff;
+// Directory-format (0x465456) records store preload size and archive index as u32
+constexpr uint32_t DIR_ENTRY_METADATA_SIZE = 22;
+
+// Archive index of data stored in the directory file itself, right after the tree
+constexpr uint32_t EMBEDDED_ARCHIVE_INDEX = 0x7fff;
+
+// Directory and extension name the tree uses for "none"
+constexpr const char* EMPTY_NAME = " ";
+
+// Longest extension and longest directory path or file stem an entry may have. Tree strings are
+// read through a window of MAX_NAME_LENGTH + 1 bytes, terminator included.
+constexpr size_t MAX_EXTENSION_LENGTH = 50;
+constexpr size_t MAX_NAME_LENGTH = 255;
+
+// Preload bytes are counted in a u16 field
+constexpr uint32_t MAX_PRELOAD_SIZE = 0xffff;
+
+// v2 checksum sections: one record per hashed volume chunk, then the tree, archive-MD5
+// section and whole-file digests
+constexpr uint32_t ARCHIVE_MD5_ENTRY_SIZE = 28;
+constexpr uint32_t OTHER_MD5_SECTION_SIZE = 48;
+
+} // namespace unpaker::parsers::vpk
@@ -5,14 +5,17 @@
 #pragma once
 
 #include "base_parser.hpp"
+#include "mapped_file.hpp"
 #include <fstream>
+#include <map>
+#include <mutex>
 
 namespace unpaker::parsers {
 
 class VpkParser : public BaseParser {
 public:
     bool parse(const fs::path& archive_path,
-                              std::shared_ptr<DirectoryEntry>& root,
+                              ArchiveIndexBuilder& index,
                               uint32_t& file_count) override;
 
     bool detect(const fs::path& archive_path) override;
@@ -21,26 +24,87 @@ public:
                                          const std::shared_ptr<FileEntry>& file,
                                          std::vector<uint8_t>& data) const override;
 
+    bool extract_into(const fs::path& archive_path,
+                      const std::shared_ptr<FileEntry>& file,
+                      uint8_t* buffer,
+                      size_t capacity,
+                      size_t& bytes_read) const override;
+
+    // Preload bytes and embedded data come straight from the mapped directory file
+    EntryStream open_entry(const fs::path& archive_path,
+                           const std::shared_ptr<FileEntry>& file) const override;
+
+    bool provides_crc32() const override { return true; }
+
+    // Hashes the data volumes chunk by chunk against the v2 archive MD5 section and checks the
+    // tree, archive-MD5 section and whole-file digests from the other-MD5 section
+    SectionChecksumReport verify_section_checksums(const fs::path& archive_path) const override;
+
+    // Groups entries by data volume and serves each volume with offset-ordered, coalesced reads
+    size_t extract_files(const fs::path& archive_path,
+                         const std::vector<std::shared_ptr<FileEntry>>& files,
+                         const ExtractCallback& on_extracted,
+                         uint32_t read_threads) const override;
+
+    // The directory copy and every data volume found next to it
+    void open_pinned_files(const fs::path& archive_path) const override;
+
 private:
-    bool parse_vpk_v2(std::ifstream& file,
-                                         std::shared_ptr<DirectoryEntry>& root,
+    bool parse_vpk_v2(const MappedFile& mapping,
+                                         ArchiveIndexBuilder& index,
                                          uint32_t& file_count);
 
-    bool parse_vpk_dir(std::ifstream& file,
-                                              std::shared_ptr<DirectoryEntry>& root,
+    bool parse_vpk_dir(const MappedFile& mapping,
+                                              ArchiveIndexBuilder& index,
                                               uint32_t& file_count);
 
-    void build_directory_structure(std::shared_ptr<DirectoryEntry>& root);
 
-    std::string read_cstring(std::ifstream& file);
+    struct DataVolume {
+        fs::path path;
+        uint64_t size = 0;
+    };
+
+    // Data volumes of one archive set, resolved once per archive
+    struct VolumeTable {
+        fs::path archive_path;
+        std::map<uint32_t, DataVolume> volumes;
+        uint64_t embedded_data_offset = 0;
+    };
+
+    // Maps the directory file, or reads it into memory when pin_files is set
+    std::shared_ptr<MappedFile> open_directory(const fs::path& archive_path) const;
+    std::shared_ptr<const MappedFile> get_directory_mapping(const fs::path& archive_path) const;
+    std::shared_ptr<const VolumeTable> get_volumes(const fs::path& archive_path) const;
+
+    static std::shared_ptr<const VolumeTable> discover_volumes(const fs::path& archive_path,
+                                                                                                               const MappedFile* mapping);
+
+    bool read_preload(const fs::path& archive_path,
+                                           const FileEntry& file,
+                                           uint8_t* destination) const;
+
+    bool read_embedded(const fs::path& archive_path,
+                                            const VolumeTable& table,
+                                            uint64_t offset,
+                                            uint32_t length,
+                                            uint8_t* destination) const;
+
+    // Both succeed only when all length bytes were read; bytes_read reports how far a failed read got
+    bool read_from_volume(const DataVolume& volume,
+                                                  uint64_t offset,
+                                                  uint32_t length,
+                                                  uint8_t* destination,
+                                                  size_t& bytes_read) const;
 
-    bool read_from_data_file(const fs::path& data_file_path,
-                                                         const std::shared_ptr<FileEntry>& file,
-                                                         std::vector<uint8_t>& data) const;
+    bool fallback_search_data_archives(const VolumeTable& table,
+                                                                               const FileEntry& file,
+                                                                               uint8_t* destination,
+                                                                               size_t& bytes_read) const;
 
-    bool fallback_search_data_archives(const fs::path& archive_path,
-                                                                               const std::shared_ptr<FileEntry>& file,
-                                                                               std::vector<uint8_t>& data) const;
+    mutable std::mutex mapping_mutex;
+    mutable std::shared_ptr<const MappedFile> directory_mapping;
+    mutable fs::path directory_mapping_path;
+    mutable std::shared_ptr<const VolumeTable> volume_table;
 };
 
 } // namespace unpaker::parsers
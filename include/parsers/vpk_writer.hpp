@@ -0,0 +1,94 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "md5.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker::parsers {
+
+struct VpkWriterOptions {
+    // Data volumes are closed once they reach this size; an entry never spans two volumes
+    uint64_t max_volume_size = 200ull * 1024 * 1024;
+    // Granularity of the archive MD5 section
+    uint32_t md5_chunk_size = 1024 * 1024;
+    bool write_md5_sections = true;
+    // Entries whose volume data is byte-identical share one copy
+    bool deduplicate = true;
+    // Worker threads for hashing and volume writes; 0 means one per hardware thread
+    uint32_t thread_count = 0;
+};
+
+struct VpkWriteReport {
+    uint32_t entries = 0;
+    uint32_t volumes = 0;
+    uint32_t deduplicated_entries = 0;
+    // Volumes of an earlier, larger set with the same name that were deleted
+    uint32_t stale_volumes_removed = 0;
+    uint64_t bytes_written = 0;
+    uint64_t bytes_saved = 0;
+    double seconds = 0.0;
+};
+
+// Builds a VPK v2 set: "<name>_dir.vpk" with the tree and checksum sections, and data volumes
+// "<name>_000.vpk", "<name>_001.vpk", ... next to it. Sources are only read while writing, once
+// to checksum and once to copy, so the set can be much larger than memory.
+class VpkWriter {
+public:
+    explicit VpkWriter(const VpkWriterOptions& options = VpkWriterOptions());
+
+    // archive_path uses '/' separators; the first preload_size bytes are stored in the tree
+    bool add_file(const std::string& archive_path, const fs::path& source, uint32_t preload_size = 0);
+    bool add_data(const std::string& archive_path, std::vector<uint8_t> data, uint32_t preload_size = 0);
+
+    size_t size() const { return entries.size(); }
+
+    // dir_path must name the "_dir.vpk" file; existing volumes with the same prefix are overwritten
+    // and any numbered past the new set are deleted
+    bool write(const fs::path& dir_path);
+
+    const VpkWriteReport& report() const { return last_report; }
+
+private:
+    struct PendingEntry {
+        std::string extension;
+        std::string directory;
+        std::string stem;
+        fs::path source;
+        std::vector<uint8_t> data;
+        bool in_memory = false;
+        uint32_t requested_preload = 0;
+
+        // Filled in by write()
+        uint64_t size = 0;
+        uint32_t crc = 0;
+        Md5Digest content_digest{};
+        std::vector<uint8_t> preload;
+        uint16_t archive_index = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        bool duplicate = false;
+    };
+
+    bool add_entry(const std::string& archive_path, PendingEntry entry);
+    bool load(const PendingEntry& entry, std::vector<uint8_t>& buffer) const;
+    bool hash_entries(std::vector<std::string>& errors);
+    bool lay_out_volumes();
+    bool write_volumes(const std::vector<fs::path>& volume_paths);
+    std::vector<uint8_t> build_tree() const;
+    std::vector<uint8_t> hash_volume_chunks(const std::vector<fs::path>& volume_paths, bool& ok) const;
+
+    VpkWriterOptions options;
+    std::vector<PendingEntry> entries;
+    std::vector<uint64_t> volume_sizes;
+    VpkWriteReport last_report;
+};
+
+} // namespace unpaker::parsers
@@ -0,0 +1,56 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "archive_index.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace unpaker {
+
+// Two entries whose paths are equal once folded; lookups resolve to `kept`
+struct PathCollision {
+    EntryId kept = INVALID_ENTRY_ID;
+    EntryId shadowed = INVALID_ENTRY_ID;
+};
+
+// Hash table from full entry path to EntryId. Paths are matched the way the Source engine
+// resolves them: '\\' and '/' are interchangeable, repeated separators and "." components are
+// ignored, and ASCII letters compare case-insensitively. Queries hash the caller's string in
+// place and confirm a hit against the index, so a lookup never allocates.
+class PathLookup {
+public:
+    void build(const ArchiveIndex& index);
+    void clear();
+
+    EntryId find(const ArchiveIndex& index, std::string_view path) const;
+
+    // Walks the directory spans of the index with the same matching rules; "" is the root
+    static DirId find_directory(const ArchiveIndex& index, std::string_view path);
+
+    const std::vector<PathCollision>& collisions() const { return path_collisions; }
+    size_t memory_usage() const;
+
+    static uint64_t hash_path(std::string_view path);
+    // hash_path() of every entry of the index, indexed by EntryId, without building the paths
+    static std::vector<uint64_t> hash_entries(const ArchiveIndex& index);
+
+    // True if the entry's full path equals path under the matching rules above
+    static bool matches(const ArchiveIndex& index, EntryId id, std::string_view path);
+    static bool same_path(std::string_view a, std::string_view b);
+
+private:
+    struct Slot {
+        uint32_t tag;
+        EntryId id;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    std::vector<PathCollision> path_collisions;
+};
+
+} // namespace unpaker
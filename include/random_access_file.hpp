@@ -0,0 +1,60 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+// One destination buffer of a vectored read
+struct IoSlice {
+    void* data;
+    size_t length;
+};
+
+// Read-only file handle with positional reads. read_at() never touches a shared file pointer,
+// so one handle can serve any number of threads at once.
+class RandomAccessFile {
+public:
+    RandomAccessFile() = default;
+    ~RandomAccessFile();
+
+    RandomAccessFile(const RandomAccessFile&) = delete;
+    RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+
+    bool open(const fs::path& path);
+    void close();
+
+    bool is_open() const;
+    uint64_t size() const { return size_; }
+    const fs::path& path() const { return path_; }
+
+    // Returns the number of bytes read, which is short only at end of file or on error
+    size_t read_at(uint64_t offset, void* buffer, size_t length) const;
+
+    // Reads one contiguous range starting at offset into consecutive slices
+    size_t read_vectored(uint64_t offset, const IoSlice* slices, size_t count) const;
+
+#ifndef _WIN32
+    // Descriptor for submitting reads elsewhere, such as an io_uring queue
+    int descriptor() const { return fd_; }
+#endif
+
+private:
+    fs::path path_;
+    uint64_t size_ = 0;
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace unpaker
@@ -0,0 +1,36 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "ascii.hpp"
+#include <string_view>
+
+namespace unpaker {
+
+// Extensions of entries treated as plain text, by the preview pane and by the text index
+constexpr const char* TEXT_EXTENSIONS[] = {"txt", "cfg", "ini", "md", "log", "conf", "config", "properties", "xml", "json"};
+
+// True if the file name ends in one of TEXT_EXTENSIONS, ignoring ASCII case
+inline bool is_text_asset(std::string_view file_name) {
+    size_t dot = file_name.find_last_of('.');
+    if (dot == std::string_view::npos) {
+        return false;
+    }
+
+    std::string_view extension = file_name.substr(dot + 1);
+    for (std::string_view supported : TEXT_EXTENSIONS) {
+        if (supported.size() != extension.size()) continue;
+        bool equal = true;
+        for (size_t i = 0; i < extension.size() && equal; ++i) {
+            equal = fold_ascii(extension[i]) == supported[i];
+        }
+        if (equal) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace unpaker
@@ -0,0 +1,92 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include "content_search.hpp"
+#include "pak_parser.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace unpaker {
+
+struct TextIndexStats {
+    uint32_t documents = 0;
+    // Entries whose trigrams were carried over from the stored index, and entries read now
+    uint32_t reused = 0;
+    uint32_t indexed = 0;
+    uint32_t failed = 0;
+    uint64_t bytes_read = 0;
+    size_t trigrams = 0;
+    size_t postings = 0;
+    // The stored index matched the archive and was used as is
+    bool loaded = false;
+    double seconds = 0.0;
+};
+
+// Trigram index over the text assets of one archive (see TEXT_EXTENSIONS). Every distinct run of
+// three bytes, with ASCII case folded, has a posting list of the entries containing it, so a
+// literal search only reads the entries holding all of its trigrams. The index is stored beside
+// the archive's index cache; when the archive changes, entries whose path, size and CRC-32 are
+// unchanged keep their trigrams and only the rest are read again.
+class TextIndex {
+public:
+    TextIndex();
+    explicit TextIndex(const fs::path& cache_dir);
+
+    // Uses the stored index if it still describes the archive, otherwise builds on what it has
+    // and stores the result. Returns false only if nothing could be indexed.
+    bool open(const PakParser& parser, uint32_t thread_count = 0);
+    void build(const PakParser& parser, uint32_t thread_count = 0, const TextIndex* previous = nullptr);
+
+    bool load(const fs::path& archive_path);
+    bool store(const fs::path& archive_path) const;
+    fs::path get_index_file(const fs::path& archive_path) const;
+
+    // Indexed entries that contain every trigram of the literal, in EntryId order, plus every
+    // entry that could not be read when it was indexed. Literals shorter than three bytes cannot
+    // be narrowed down and return every indexed entry.
+    std::vector<EntryId> candidates(std::string_view literal) const;
+    // Entries that may contain any of the literals
+    std::vector<EntryId> candidates(const std::vector<std::string>& literals) const;
+
+    // ContentSearch over the candidates only; entries that are not text assets are not searched
+    SearchResult search(const PakParser& parser, const SearchOptions& options) const;
+
+    size_t document_count() const { return document_entries.size(); }
+    const TextIndexStats& stats() const { return statistics; }
+
+private:
+    // Sorted trigram keys of each document, rebuilt from the posting lists
+    std::vector<std::vector<uint32_t>> document_trigrams() const;
+    const uint32_t* find_postings(uint32_t trigram, size_t& count) const;
+
+    fs::path cache_dir;
+    // Size and modification time of the archive file this index was built from
+    uint64_t archive_size = 0;
+    int64_t archive_mtime = 0;
+    bool has_checksums = false;
+
+    // One row per indexed entry, in EntryId order; postings refer to rows, not EntryIds
+    std::vector<EntryId> document_entries;
+    std::vector<uint32_t> document_sizes;
+    std::vector<uint32_t> document_crcs;
+    std::vector<uint64_t> document_path_hashes;
+    // Sorted rows whose entry could not be read in full; they carry no trigrams, are candidates
+    // for every literal and are read again on the next build
+    std::vector<uint32_t> failed_documents;
+    // Posting lists in CSR form: trigram_keys[i] owns postings[posting_starts[i], posting_starts[i + 1])
+    std::vector<uint32_t> trigram_keys;
+    std::vector<uint32_t> posting_starts;
+    std::vector<uint32_t> postings;
+
+    TextIndexStats statistics;
+};
+
+} // namespace unpaker
@@ -0,0 +1,74 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace unpaker {
+
+class ThreadPool {
+public:
+    // thread_count == 0 selects std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    // Runs body(0) .. body(count - 1) across the pool and the calling thread, returning once all
+    // iterations have finished. The first exception thrown by an iteration is rethrown.
+    void parallel_for(size_t count, const std::function<void(size_t)>& body);
+
+    size_t size() const;
+
+    static size_t resolve_thread_count(size_t requested);
+
+    // Runs body(0) .. body(count - 1) on at most thread_count threads (0 selects
+    // hardware_concurrency()), the calling thread included. A pool is created for the call only
+    // when more than one thread would have work; otherwise the loop runs inline.
+    template <typename Body>
+    static void run(size_t count, size_t thread_count, const Body& body) {
+        size_t threads = std::min(resolve_thread_count(thread_count), count);
+        if (threads > 1) {
+            ThreadPool pool(threads - 1);
+            pool.parallel_for(count, body);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                body(i);
+            }
+        }
+    }
+
+private:
+    void enqueue(std::function<void()> task);
+    void worker_loop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    bool stopping = false;
+};
+
+} // namespace unpaker
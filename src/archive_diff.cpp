@@ -0,0 +1,349 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "archive_diff.hpp"
+#include "logger.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <utility>
+
+namespace unpaker {
+
+namespace {
+
+struct MoveKey {
+    uint32_t size;
+    uint32_t crc;
+
+    bool operator<(const MoveKey& other) const {
+        return size != other.size ? size < other.size : crc < other.crc;
+    }
+};
+
+struct MoveGroup {
+    std::vector<EntryId> removed;
+    std::vector<EntryId> added;
+};
+
+std::string json_escape(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+std::string hex_crc(uint32_t crc) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%08x", crc);
+    return buffer;
+}
+
+} // namespace
+
+const char* ArchiveDiff::status_name(DiffStatus status) {
+    switch (status) {
+        case DiffStatus::ADDED: return "added";
+        case DiffStatus::REMOVED: return "removed";
+        case DiffStatus::MODIFIED: return "modified";
+        case DiffStatus::MOVED: return "moved";
+        case DiffStatus::UNCHANGED: return "unchanged";
+    }
+    return "unknown";
+}
+
+ArchiveDiffResult ArchiveDiff::compare(const PakParser& old_archive,
+                                       const PakParser& new_archive,
+                                       const DiffOptions& options) {
+    ArchiveDiffResult result;
+    auto start_time = std::chrono::steady_clock::now();
+
+    const ArchiveIndex& old_index = old_archive.get_index();
+    const ArchiveIndex& new_index = new_archive.get_index();
+    const bool crcs = old_archive.has_entry_checksums() && new_archive.has_entry_checksums();
+
+    std::vector<DiffEntry> entries;
+    std::vector<bool> matched(new_index.entry_count(), false);
+    std::vector<EntryId> removed;
+
+    for (EntryId old_id = 0; old_id < old_index.entry_count(); ++old_id) {
+        std::string path = old_index.path(old_id);
+        EntryId new_id = new_archive.find(path);
+        if (new_id == INVALID_ENTRY_ID) {
+            removed.push_back(old_id);
+            continue;
+        }
+        matched[new_id] = true;
+
+        DiffEntry entry;
+        entry.path = std::move(path);
+        entry.old_id = old_id;
+        entry.new_id = new_id;
+        entry.old_size = old_index.size(old_id);
+        entry.new_size = new_index.size(new_id);
+        entry.old_crc = old_index.crc(old_id);
+        entry.new_crc = new_index.crc(new_id);
+
+        if (entry.old_size != entry.new_size || (crcs && entry.old_crc != entry.new_crc)) {
+            entry.status = DiffStatus::MODIFIED;
+        } else {
+            // Same size and no CRC to tell the data apart
+            entry.ambiguous = !crcs && entry.old_size > 0;
+            if (!entry.ambiguous && !options.include_unchanged) {
+                result.unchanged++;
+                continue;
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    std::vector<EntryId> added;
+    for (EntryId new_id = 0; new_id < new_index.entry_count(); ++new_id) {
+        if (!matched[new_id]) {
+            added.push_back(new_id);
+        }
+    }
+
+    // Pair removed and added entries with identical metadata. Empty files all look alike and are
+    // never paired. Without CRCs only the size matches, so every pair is ambiguous.
+    std::map<MoveKey, MoveGroup> groups;
+    for (EntryId id : removed) {
+        if (old_index.size(id) > 0) {
+            groups[{old_index.size(id), crcs ? old_index.crc(id) : 0}].removed.push_back(id);
+        }
+    }
+    for (EntryId id : added) {
+        if (new_index.size(id) == 0) continue;
+        auto it = groups.find({new_index.size(id), crcs ? new_index.crc(id) : 0});
+        if (it != groups.end()) {
+            it->second.added.push_back(id);
+        }
+    }
+
+    std::vector<bool> moved_old(old_index.entry_count(), false);
+    std::vector<bool> moved_new(new_index.entry_count(), false);
+    for (auto& [key, group] : groups) {
+        if (group.added.empty()) continue;
+        bool ambiguous = !crcs || group.removed.size() > 1 || group.added.size() > 1;
+
+        // Prefer a candidate with the same file name, so renamed directories pair up predictably
+        for (EntryId old_id : group.removed) {
+            EntryId new_id = INVALID_ENTRY_ID;
+            for (EntryId candidate : group.added) {
+                if (moved_new[candidate]) continue;
+                if (new_id == INVALID_ENTRY_ID) {
+                    new_id = candidate;
+                }
+                if (new_index.name(candidate) == old_index.name(old_id)) {
+                    new_id = candidate;
+                    break;
+                }
+            }
+            if (new_id == INVALID_ENTRY_ID) break;
+
+            moved_old[old_id] = true;
+            moved_new[new_id] = true;
+
+            DiffEntry entry;
+            entry.status = DiffStatus::MOVED;
+            entry.path = new_index.path(new_id);
+            entry.old_path = old_index.path(old_id);
+            entry.old_id = old_id;
+            entry.new_id = new_id;
+            entry.old_size = key.size;
+            entry.new_size = key.size;
+            entry.old_crc = old_index.crc(old_id);
+            entry.new_crc = new_index.crc(new_id);
+            entry.ambiguous = ambiguous;
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    if (options.confirm_ambiguous) {
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].ambiguous) {
+                pending.push_back(i);
+            }
+        }
+
+        std::vector<uint8_t> same(pending.size(), 0);
+        std::vector<uint8_t> readable(pending.size(), 0);
+        auto confirm = [&](size_t i) {
+            const DiffEntry& entry = entries[pending[i]];
+            std::vector<uint8_t> old_data;
+            std::vector<uint8_t> new_data;
+            if (old_archive.extract_entry(entry.old_id, old_data) &&
+                new_archive.extract_entry(entry.new_id, new_data)) {
+                readable[i] = 1;
+                same[i] = old_data == new_data ? 1 : 0;
+            }
+        };
+
+        ThreadPool::run(pending.size(), options.thread_count, confirm);
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            DiffEntry& entry = entries[pending[i]];
+            if (!readable[i]) {
+                Logger::instance().warning("Cannot confirm " + entry.path + ": extraction failed");
+                continue;
+            }
+            entry.ambiguous = false;
+            entry.confirmed = true;
+            if (same[i]) continue;
+
+            if (entry.status == DiffStatus::MOVED) {
+                // Different data after all: the pair is a removal and an unrelated addition
+                moved_old[entry.old_id] = false;
+                moved_new[entry.new_id] = false;
+                entry.status = DiffStatus::REMOVED;
+            } else {
+                entry.status = DiffStatus::MODIFIED;
+            }
+        }
+
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const DiffEntry& entry) {
+            if (entry.status == DiffStatus::REMOVED) return true;
+            if (entry.status == DiffStatus::UNCHANGED && !entry.ambiguous && !options.include_unchanged) {
+                result.unchanged++;
+                return true;
+            }
+            return false;
+        }), entries.end());
+    }
+
+    for (EntryId old_id : removed) {
+        if (moved_old[old_id]) continue;
+        DiffEntry entry;
+        entry.status = DiffStatus::REMOVED;
+        entry.path = old_index.path(old_id);
+        entry.old_id = old_id;
+        entry.old_size = old_index.size(old_id);
+        entry.old_crc = old_index.crc(old_id);
+        entries.push_back(std::move(entry));
+    }
+    for (EntryId new_id : added) {
+        if (moved_new[new_id]) continue;
+        DiffEntry entry;
+        entry.status = DiffStatus::ADDED;
+        entry.path = new_index.path(new_id);
+        entry.new_id = new_id;
+        entry.new_size = new_index.size(new_id);
+        entry.new_crc = new_index.crc(new_id);
+        entries.push_back(std::move(entry));
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const DiffEntry& a, const DiffEntry& b) {
+        return a.path != b.path ? a.path < b.path : a.status < b.status;
+    });
+
+    for (const DiffEntry& entry : entries) {
+        switch (entry.status) {
+            case DiffStatus::ADDED: result.added++; break;
+            case DiffStatus::REMOVED: result.removed++; break;
+            case DiffStatus::MODIFIED: result.modified++; break;
+            case DiffStatus::MOVED: result.moved++; break;
+            case DiffStatus::UNCHANGED: result.unchanged++; break;
+        }
+        if (entry.ambiguous) result.ambiguous++;
+        if (entry.confirmed) result.confirmed++;
+    }
+    result.entries = std::move(entries);
+
+    auto end_time = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(end_time - start_time).count();
+    return result;
+}
+
+void ArchiveDiff::write_text(std::ostream& out, const ArchiveDiffResult& result) {
+    for (const DiffEntry& entry : result.entries) {
+        char marker = '=';
+        switch (entry.status) {
+            case DiffStatus::ADDED: marker = '+'; break;
+            case DiffStatus::REMOVED: marker = '-'; break;
+            case DiffStatus::MODIFIED: marker = 'M'; break;
+            case DiffStatus::MOVED: marker = 'R'; break;
+            case DiffStatus::UNCHANGED: marker = '='; break;
+        }
+
+        out << marker << (entry.ambiguous ? '?' : ' ') << ' ';
+        if (entry.status == DiffStatus::MOVED) {
+            out << entry.old_path << " -> ";
+        }
+        out << entry.path;
+
+        if (entry.status == DiffStatus::MODIFIED) {
+            out << " (" << entry.old_size << " -> " << entry.new_size << " bytes)";
+        } else if (entry.status == DiffStatus::REMOVED) {
+            out << " (" << entry.old_size << " bytes)";
+        } else {
+            out << " (" << entry.new_size << " bytes)";
+        }
+        out << '\n';
+    }
+
+    out << "Added: " << result.added
+        << ", removed: " << result.removed
+        << ", modified: " << result.modified
+        << ", moved: " << result.moved
+        << ", unchanged: " << result.unchanged;
+    if (result.ambiguous > 0) {
+        out << ", ambiguous: " << result.ambiguous;
+    }
+    if (result.confirmed > 0) {
+        out << ", confirmed by content: " << result.confirmed;
+    }
+    out << '\n';
+}
+
+void ArchiveDiff::write_ndjson(std::ostream& out, const ArchiveDiffResult& result) {
+    for (const DiffEntry& entry : result.entries) {
+        out << "{\"status\":\"" << status_name(entry.status) << "\""
+            << ",\"path\":\"" << json_escape(entry.path) << "\"";
+        if (entry.status == DiffStatus::MOVED) {
+            out << ",\"old_path\":\"" << json_escape(entry.old_path) << "\"";
+        }
+        if (entry.old_id != INVALID_ENTRY_ID) {
+            out << ",\"old_size\":" << entry.old_size
+                << ",\"old_crc\":\"" << hex_crc(entry.old_crc) << "\"";
+        }
+        if (entry.new_id != INVALID_ENTRY_ID) {
+            out << ",\"new_size\":" << entry.new_size
+                << ",\"new_crc\":\"" << hex_crc(entry.new_crc) << "\"";
+        }
+        out << ",\"ambiguous\":" << (entry.ambiguous ? "true" : "false")
+            << ",\"confirmed\":" << (entry.confirmed ? "true" : "false")
+            << "}\n";
+    }
+
+    out << "{\"summary\":{\"added\":" << result.added
+        << ",\"removed\":" << result.removed
+        << ",\"modified\":" << result.modified
+        << ",\"moved\":" << result.moved
+        << ",\"unchanged\":" << result.unchanged
+        << ",\"ambiguous\":" << result.ambiguous
+        << ",\"confirmed\":" << result.confirmed
+        << ",\"seconds\":" << result.seconds
+        << "}}\n";
+}
+
+} // namespace unpaker
@@ -0,0 +1,326 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "archive_extractor.hpp"
+#include "logger.hpp"
+#include "md5.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace unpaker {
+
+namespace {
+
+// Work unit for the write pass: a run of entries in volume and offset order
+constexpr uint64_t WRITE_CHUNK_BYTES = 32 * 1024 * 1024;
+constexpr size_t WRITE_CHUNK_ENTRIES = 4096;
+// Larger entries are copied through a stream instead of being extracted whole
+constexpr uint64_t STREAMED_ENTRY_SIZE = 16 * 1024 * 1024;
+
+constexpr size_t NOT_DUPLICATE = static_cast<size_t>(-1);
+
+struct WriteChunk {
+    size_t begin;
+    size_t end;
+    bool streamed = false;
+};
+
+struct WriteChunkResult {
+    uint32_t written = 0;
+    uint64_t bytes = 0;
+    std::vector<std::string> failures;
+};
+
+// Archive paths come from the archive itself; refuse anything that would land outside output_dir
+bool is_safe_relative_path(const std::string& path) {
+    if (path.empty() || path[0] == '/' || path[0] == '\\' || path.find(':') != std::string::npos) {
+        return false;
+    }
+
+    size_t pos = 0;
+    while (pos <= path.size()) {
+        size_t next = path.find_first_of("/\\", pos);
+        if (next == std::string::npos) next = path.size();
+        if (path.compare(pos, next - pos, "..") == 0 && next - pos == 2) {
+            return false;
+        }
+        pos = next + 1;
+    }
+    return true;
+}
+
+// A previous --dedupe run may have left path as a hard link; writing through it would overwrite
+// every other name on the link, so the old file is unlinked and a new one created
+std::ofstream open_output(const fs::path& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+    return std::ofstream(path, std::ios::binary | std::ios::trunc);
+}
+
+bool write_data(const fs::path& path, const std::vector<uint8_t>& data) {
+    std::ofstream out = open_output(path);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+bool write_stream(const PakParser& parser, const std::shared_ptr<FileEntry>& file, const fs::path& path) {
+    EntryStream stream = parser.open_file(file);
+    if (!stream.is_open() || stream.size() != file->size) {
+        return false;
+    }
+
+    std::ofstream out = open_output(path);
+    if (!out) return false;
+    bool complete = stream.copy_to([&out](const uint8_t* data, size_t length) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+        return static_cast<bool>(out);
+    });
+    return complete && static_cast<bool>(out);
+}
+
+
+} // namespace
+
+ExtractReport ArchiveExtractor::extract_all(const PakParser& parser,
+                                            const fs::path& output_dir,
+                                            const ExtractOptions& options) {
+    std::vector<EntryId> entries(parser.get_index().entry_count());
+    for (EntryId id = 0; id < entries.size(); ++id) {
+        entries[id] = id;
+    }
+    return extract(parser, entries, output_dir, options);
+}
+
+ExtractReport ArchiveExtractor::extract(const PakParser& parser,
+                                        const std::vector<EntryId>& entries,
+                                        const fs::path& output_dir,
+                                        const ExtractOptions& options) {
+    ExtractReport report;
+    auto start_time = std::chrono::steady_clock::now();
+    report.total_files = static_cast<uint32_t>(entries.size());
+
+    const ArchiveIndex& index = parser.get_index();
+
+    // Resolve targets and create each output directory once
+    std::vector<fs::path> targets(entries.size());
+    std::vector<uint8_t> valid(entries.size(), 0);
+    std::set<DirId> directories;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        EntryId id = entries[i];
+        if (id >= index.entry_count()) {
+            report.failures.push_back("Invalid entry id " + std::to_string(id));
+            continue;
+        }
+        std::string path = index.path(id);
+        if (!is_safe_relative_path(path)) {
+            report.failures.push_back("Unsafe path: " + path);
+            continue;
+        }
+        targets[i] = output_dir / fs::path(path).make_preferred();
+        valid[i] = 1;
+        directories.insert(index.directory_of(id));
+    }
+
+    std::error_code ec;
+    fs::create_directories(output_dir, ec);
+    for (DirId dir : directories) {
+        if (dir == ROOT_DIR_ID) continue;
+        fs::create_directories(output_dir / fs::path(index.directory_path(dir)).make_preferred(), ec);
+        if (ec) {
+            report.failures.push_back("Cannot create directory " + index.directory_path(dir) + ": " + ec.message());
+        }
+    }
+
+    // Entries with equal size and CRC are only candidates; an MD5 of the contents decides
+    std::vector<size_t> canonical(entries.size(), NOT_DUPLICATE);
+    if (options.deduplicate) {
+        const bool crcs = parser.has_entry_checksums();
+        std::map<std::pair<uint32_t, uint32_t>, std::vector<size_t>> groups;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (!valid[i] || index.size(entries[i]) == 0) continue;
+            groups[{index.size(entries[i]), crcs ? index.crc(entries[i]) : 0}].push_back(i);
+        }
+
+        std::vector<size_t> candidates;
+        for (const auto& [key, members] : groups) {
+            if (members.size() > 1) {
+                candidates.insert(candidates.end(), members.begin(), members.end());
+            }
+        }
+
+        std::vector<Md5Digest> digests(entries.size());
+        std::vector<uint8_t> hashed(entries.size(), 0);
+        ThreadPool::run(candidates.size(), options.thread_count, [&](size_t c) {
+            size_t i = candidates[c];
+            EntryStream stream = parser.open_entry(entries[i]);
+            Md5 md5;
+            if (stream.is_open() && stream.copy_to([&md5](const uint8_t* data, size_t length) {
+                    md5.update(data, length);
+                    return true;
+                })) {
+                digests[i] = md5.finalize();
+                hashed[i] = 1;
+            }
+        });
+
+        for (const auto& [key, members] : groups) {
+            if (members.size() < 2) continue;
+            std::map<Md5Digest, size_t> first_by_digest;
+            for (size_t i : members) {
+                if (!hashed[i]) continue;
+                report.bytes_hashed += key.first;
+                auto [it, inserted] = first_by_digest.emplace(digests[i], i);
+                if (!inserted) {
+                    canonical[i] = it->second;
+                }
+            }
+        }
+    }
+
+    // Write every entry that is not a confirmed duplicate, sweeping each volume in offset order
+    std::vector<size_t> order;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (valid[i] && canonical[i] == NOT_DUPLICATE) {
+            order.push_back(i);
+        }
+    }
+    const auto& volumes = index.archive_index_column();
+    const auto& offsets = index.offset_column();
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        EntryId x = entries[a];
+        EntryId y = entries[b];
+        return volumes[x] != volumes[y] ? volumes[x] < volumes[y] : offsets[x] < offsets[y];
+    });
+
+    std::vector<WriteChunk> chunks;
+    size_t chunk_begin = 0;
+    uint64_t chunk_bytes = 0;
+    for (size_t k = 0; k < order.size(); ++k) {
+        uint32_t size = index.size(entries[order[k]]);
+        bool streamed = size > STREAMED_ENTRY_SIZE;
+        if (k > chunk_begin && (streamed || chunk_bytes >= WRITE_CHUNK_BYTES || k - chunk_begin >= WRITE_CHUNK_ENTRIES)) {
+            chunks.push_back({chunk_begin, k});
+            chunk_begin = k;
+            chunk_bytes = 0;
+        }
+        if (streamed) {
+            chunks.push_back({k, k + 1, true});
+            chunk_begin = k + 1;
+            continue;
+        }
+        chunk_bytes += size;
+    }
+    if (chunk_begin < order.size()) {
+        chunks.push_back({chunk_begin, order.size()});
+    }
+
+    std::vector<uint8_t> written(entries.size(), 0);
+    std::vector<WriteChunkResult> results(chunks.size());
+    // Chunks already spread over the threads, so each one reads its batch on its own thread
+    uint32_t read_threads = std::min(ThreadPool::resolve_thread_count(options.thread_count), chunks.size()) > 1 ? 1 : 0;
+    ThreadPool::run(chunks.size(), options.thread_count, [&](size_t c) {
+        WriteChunkResult& result = results[c];
+        if (chunks[c].streamed) {
+            size_t i = order[chunks[c].begin];
+            auto file = index.make_file_entry(entries[i]);
+            if (write_stream(parser, file, targets[i])) {
+                written[i] = 1;
+                result.written++;
+                result.bytes += file->size;
+            } else {
+                result.failures.push_back("Cannot write " + file->path);
+            }
+            return;
+        }
+
+        std::vector<std::shared_ptr<FileEntry>> batch;
+        std::unordered_map<const FileEntry*, size_t> slots;
+        for (size_t k = chunks[c].begin; k < chunks[c].end; ++k) {
+            batch.push_back(index.make_file_entry(entries[order[k]]));
+            slots[batch.back().get()] = order[k];
+        }
+
+        parser.extract_files(batch, [&](const std::shared_ptr<FileEntry>& file,
+                                        bool success,
+                                        std::vector<uint8_t>& data) {
+            size_t i = slots[file.get()];
+            if (success && data.size() == file->size && write_data(targets[i], data)) {
+                written[i] = 1;
+                result.written++;
+                result.bytes += data.size();
+            } else {
+                result.failures.push_back("Cannot write " + file->path);
+            }
+        }, read_threads);
+    });
+
+    for (auto& result : results) {
+        report.written_files += result.written;
+        report.bytes_written += result.bytes;
+        report.failures.insert(report.failures.end(), result.failures.begin(), result.failures.end());
+    }
+
+    // Duplicates link to the written copy; where the filesystem refuses links they are copied,
+    // and if the copy itself failed they are extracted on their own
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t source = canonical[i];
+        if (source == NOT_DUPLICATE) continue;
+
+        uint32_t size = index.size(entries[i]);
+        if (written[source]) {
+            std::error_code link_ec;
+            fs::remove(targets[i], link_ec);
+            fs::create_hard_link(targets[source], targets[i], link_ec);
+            if (!link_ec) {
+                report.linked_files++;
+                report.bytes_saved += size;
+                continue;
+            }
+
+            std::error_code copy_ec;
+            if (fs::copy_file(targets[source], targets[i], fs::copy_options::overwrite_existing, copy_ec)) {
+                report.copied_files++;
+                report.bytes_written += size;
+                continue;
+            }
+        }
+
+        if (write_stream(parser, index.make_file_entry(entries[i]), targets[i])) {
+            report.written_files++;
+            report.bytes_written += size;
+        } else {
+            report.failures.push_back("Cannot write " + index.path(entries[i]));
+        }
+    }
+
+    report.failed_files = static_cast<uint32_t>(report.failures.size());
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    char summary[256];
+    snprintf(summary, sizeof(summary),
+             "Extracted %u/%u files in %.2f s: %.1f MB written, %u hardlinked (%.1f MB saved), %u copied",
+             report.written_files + report.linked_files + report.copied_files, report.total_files, report.seconds,
+             report.bytes_written / (1024.0 * 1024.0), report.linked_files, report.bytes_saved / (1024.0 * 1024.0),
+             report.copied_files);
+
+    if (report.failures.empty()) {
+        Logger::instance().success(summary);
+    } else {
+        Logger::instance().warning(summary);
+        for (const auto& failure : report.failures) {
+            Logger::instance().error(failure);
+        }
+    }
+
+    return report;
+}
+
+} // namespace unpaker
@@ -0,0 +1,490 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "archive_index.hpp"
+#include "pak_parser.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace unpaker {
+
+namespace {
+
+constexpr size_t MAX_NAME_LENGTH = std::numeric_limits<uint16_t>::max();
+
+template <typename T>
+void scatter(const std::vector<T>& source, const std::vector<EntryId>& destination, std::vector<T>& out) {
+    out.resize(source.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        out[destination[i]] = source[i];
+    }
+}
+
+template <typename T>
+size_t column_bytes(const std::vector<T>& column) {
+    return column.capacity() * sizeof(T);
+}
+
+void put_bytes(std::vector<uint8_t>& out, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + length);
+}
+
+template <typename T>
+void put_column(std::vector<uint8_t>& out, const std::vector<T>& column) {
+    uint64_t count = column.size();
+    put_bytes(out, &count, sizeof(count));
+    put_bytes(out, column.data(), column.size() * sizeof(T));
+}
+
+class ColumnReader {
+public:
+    ColumnReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool get(std::vector<T>& column) {
+        uint64_t count = 0;
+        if (!get_count(count, sizeof(T))) return false;
+        column.resize(static_cast<size_t>(count));
+        std::memcpy(column.data(), data + pos, column.size() * sizeof(T));
+        pos += column.size() * sizeof(T);
+        return true;
+    }
+
+    bool get(std::string& text) {
+        uint64_t count = 0;
+        if (!get_count(count, 1)) return false;
+        text.assign(reinterpret_cast<const char*>(data + pos), static_cast<size_t>(count));
+        pos += text.size();
+        return true;
+    }
+
+    bool at_end() const { return pos == size; }
+
+private:
+    bool get_count(uint64_t& count, size_t element_size) {
+        if (size - pos < sizeof(count)) return false;
+        std::memcpy(&count, data + pos, sizeof(count));
+        pos += sizeof(count);
+        return count <= (size - pos) / element_size;
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+} // namespace
+
+ArchiveIndex::ArchiveIndex()
+    : dir_name_offsets{0},
+      dir_name_lengths{0},
+      dir_parents{INVALID_DIR_ID},
+      dir_first_children{0},
+      dir_child_counts{0},
+      dir_first_files{0},
+      dir_file_counts{0} {
+}
+
+EntryRecord ArchiveIndex::record(EntryId id) const {
+    EntryRecord record;
+    record.offset = offsets[id];
+    record.size = sizes[id];
+    record.crc = crcs[id];
+    record.preload_offset = preload_offsets[id];
+    record.preload_size = preload_sizes[id];
+    record.archive_index = archive_indices[id];
+    record.storage = storages[id];
+    return record;
+}
+
+std::string ArchiveIndex::directory_path(DirId id) const {
+    std::vector<std::string_view> parts;
+    for (DirId dir = id; dir != ROOT_DIR_ID && dir != INVALID_DIR_ID; dir = dir_parents[dir]) {
+        parts.push_back(directory_name(dir));
+    }
+
+    std::string path;
+    for (auto it = parts.rbegin(); it != parts.rend(); ++it) {
+        if (!path.empty()) path += '/';
+        path.append(*it);
+    }
+    return path;
+}
+
+std::string ArchiveIndex::path(EntryId id) const {
+    std::string path = directory_path(entry_dirs[id]);
+    if (!path.empty()) path += '/';
+    path.append(name(id));
+    return path;
+}
+
+std::shared_ptr<FileEntry> ArchiveIndex::make_file_entry(EntryId id) const {
+    return make_file_entry(id, directory_path(entry_dirs[id]));
+}
+
+std::shared_ptr<FileEntry> ArchiveIndex::make_file_entry(EntryId id, const std::string& dir_path) const {
+    auto entry = std::make_shared<FileEntry>();
+    entry->name.assign(name(id));
+    entry->path = dir_path.empty() ? entry->name : dir_path + '/' + entry->name;
+    entry->offset = offsets[id];
+    entry->size = sizes[id];
+    entry->is_directory = false;
+    entry->archive_index = archive_indices[id];
+    entry->storage = storages[id];
+    entry->crc = crcs[id];
+    entry->preload_offset = preload_offsets[id];
+    entry->preload_size = preload_sizes[id];
+    return entry;
+}
+
+std::shared_ptr<DirectoryEntry> ArchiveIndex::build_tree(const std::string& root_name) const {
+    std::vector<std::shared_ptr<DirectoryEntry>> dirs(directory_count());
+    std::vector<std::string> dir_paths(directory_count());
+
+    // Parents always precede their children in DirId order
+    for (DirId d = 0; d < directory_count(); ++d) {
+        auto dir = std::make_shared<DirectoryEntry>();
+        dir->is_directory = true;
+
+        if (d == ROOT_DIR_ID) {
+            dir->name = root_name;
+        } else {
+            const auto& parent = dirs[dir_parents[d]];
+            dir->name.assign(directory_name(d));
+            dir->parent = parent;
+            parent->subdirectories.push_back(dir);
+
+            const std::string& parent_path = dir_paths[dir_parents[d]];
+            dir_paths[d] = parent_path.empty() ? dir->name : parent_path + '/' + dir->name;
+        }
+
+        dir->subdirectories.reserve(dir_child_counts[d]);
+        dir->files.reserve(dir_file_counts[d]);
+        for (EntryId e = dir_first_files[d]; e < dir_first_files[d] + dir_file_counts[d]; ++e) {
+            dir->files.push_back(make_file_entry(e, dir_paths[d]));
+        }
+
+        dirs[d] = std::move(dir);
+    }
+
+    return dirs[ROOT_DIR_ID];
+}
+
+size_t ArchiveIndex::memory_usage() const {
+    return column_bytes(offsets) + column_bytes(sizes) + column_bytes(crcs) +
+           column_bytes(preload_offsets) + column_bytes(preload_sizes) + column_bytes(archive_indices) +
+           column_bytes(storages) +
+           column_bytes(name_offsets) + column_bytes(name_lengths) + column_bytes(entry_dirs) +
+           column_bytes(dir_name_offsets) + column_bytes(dir_name_lengths) + column_bytes(dir_parents) +
+           column_bytes(dir_first_children) + column_bytes(dir_child_counts) +
+           column_bytes(dir_first_files) + column_bytes(dir_file_counts) + names.capacity();
+}
+
+void ArchiveIndex::serialize(std::vector<uint8_t>& out) const {
+    out.reserve(out.size() + memory_usage() + 16 * 18);
+
+    put_column(out, offsets);
+    put_column(out, sizes);
+    put_column(out, crcs);
+    put_column(out, preload_offsets);
+    put_column(out, preload_sizes);
+    put_column(out, archive_indices);
+    put_column(out, storages);
+    put_column(out, name_offsets);
+    put_column(out, name_lengths);
+    put_column(out, entry_dirs);
+
+    put_column(out, dir_name_offsets);
+    put_column(out, dir_name_lengths);
+    put_column(out, dir_parents);
+    put_column(out, dir_first_children);
+    put_column(out, dir_child_counts);
+    put_column(out, dir_first_files);
+    put_column(out, dir_file_counts);
+
+    uint64_t name_bytes = names.size();
+    put_bytes(out, &name_bytes, sizeof(name_bytes));
+    put_bytes(out, names.data(), names.size());
+}
+
+bool ArchiveIndex::deserialize(const uint8_t* data, size_t size) {
+    ArchiveIndex loaded;
+    ColumnReader reader(data, size);
+
+    bool ok = reader.get(loaded.offsets) && reader.get(loaded.sizes) && reader.get(loaded.crcs) &&
+              reader.get(loaded.preload_offsets) && reader.get(loaded.preload_sizes) &&
+              reader.get(loaded.archive_indices) && reader.get(loaded.storages) &&
+              reader.get(loaded.name_offsets) &&
+              reader.get(loaded.name_lengths) && reader.get(loaded.entry_dirs) &&
+              reader.get(loaded.dir_name_offsets) && reader.get(loaded.dir_name_lengths) &&
+              reader.get(loaded.dir_parents) && reader.get(loaded.dir_first_children) &&
+              reader.get(loaded.dir_child_counts) && reader.get(loaded.dir_first_files) &&
+              reader.get(loaded.dir_file_counts) && reader.get(loaded.names) && reader.at_end();
+
+    if (!ok || !loaded.is_consistent()) {
+        return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+bool ArchiveIndex::is_consistent() const {
+    const size_t entries = offsets.size();
+    if (sizes.size() != entries || crcs.size() != entries || preload_offsets.size() != entries ||
+        preload_sizes.size() != entries || archive_indices.size() != entries || storages.size() != entries ||
+        name_offsets.size() != entries || name_lengths.size() != entries || entry_dirs.size() != entries) {
+        return false;
+    }
+
+    const size_t dirs = dir_parents.size();
+    if (dirs == 0 || dir_name_offsets.size() != dirs || dir_name_lengths.size() != dirs ||
+        dir_first_children.size() != dirs || dir_child_counts.size() != dirs ||
+        dir_first_files.size() != dirs || dir_file_counts.size() != dirs ||
+        dir_parents[ROOT_DIR_ID] != INVALID_DIR_ID || entries >= INVALID_ENTRY_ID || dirs >= INVALID_DIR_ID) {
+        return false;
+    }
+
+    for (size_t e = 0; e < entries; ++e) {
+        if (static_cast<uint64_t>(name_offsets[e]) + name_lengths[e] > names.size() || entry_dirs[e] >= dirs) {
+            return false;
+        }
+    }
+
+    for (DirId d = 0; d < dirs; ++d) {
+        if (static_cast<uint64_t>(dir_name_offsets[d]) + dir_name_lengths[d] > names.size()) return false;
+        if (d != ROOT_DIR_ID && dir_parents[d] >= d) return false;
+
+        uint64_t child_end = static_cast<uint64_t>(dir_first_children[d]) + dir_child_counts[d];
+        uint64_t file_end = static_cast<uint64_t>(dir_first_files[d]) + dir_file_counts[d];
+        if (child_end > dirs || file_end > entries) return false;
+
+        for (DirId c = dir_first_children[d]; c < child_end; ++c) {
+            if (dir_parents[c] != d) return false;
+        }
+        for (EntryId e = dir_first_files[d]; e < file_end; ++e) {
+            if (entry_dirs[e] != d) return false;
+        }
+    }
+
+    return true;
+}
+
+ArchiveIndexBuilder::ArchiveIndexBuilder() {
+}
+
+void ArchiveIndexBuilder::reserve(size_t entries) {
+    staged.offsets.reserve(entries);
+    staged.sizes.reserve(entries);
+    staged.crcs.reserve(entries);
+    staged.preload_offsets.reserve(entries);
+    staged.preload_sizes.reserve(entries);
+    staged.archive_indices.reserve(entries);
+    staged.storages.reserve(entries);
+    staged.name_offsets.reserve(entries);
+    staged.name_lengths.reserve(entries);
+    staged.entry_dirs.reserve(entries);
+    staged.names.reserve(staged.names.size() + entries * 16);
+}
+
+uint64_t ArchiveIndexBuilder::child_key(DirId parent, std::string_view name) {
+    uint64_t hash = std::hash<std::string_view>()(name);
+    return hash ^ (static_cast<uint64_t>(parent) * 0x9e3779b97f4a7c15ull);
+}
+
+uint32_t ArchiveIndexBuilder::append_name(std::string_view text) {
+    uint32_t offset = static_cast<uint32_t>(staged.names.size());
+    staged.names.append(text.substr(0, MAX_NAME_LENGTH));
+    return offset;
+}
+
+DirId ArchiveIndexBuilder::child(DirId parent, std::string_view name) {
+    uint64_t key = child_key(parent, name);
+    auto range = children.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (staged.dir_parents[it->second] == parent && staged.directory_name(it->second) == name) {
+            return it->second;
+        }
+    }
+
+    DirId id = static_cast<DirId>(staged.dir_parents.size());
+    staged.dir_name_offsets.push_back(append_name(name));
+    staged.dir_name_lengths.push_back(static_cast<uint16_t>(std::min(name.size(), MAX_NAME_LENGTH)));
+    staged.dir_parents.push_back(parent);
+    staged.dir_first_children.push_back(0);
+    staged.dir_child_counts.push_back(0);
+    staged.dir_first_files.push_back(0);
+    staged.dir_file_counts.push_back(0);
+    children.emplace(key, id);
+    return id;
+}
+
+DirId ArchiveIndexBuilder::resolve(std::string_view dir_path) {
+    if (last_dir != INVALID_DIR_ID && dir_path == last_dir_path) {
+        return last_dir;
+    }
+
+    DirId current = ROOT_DIR_ID;
+    size_t pos = 0;
+    while (pos <= dir_path.size()) {
+        size_t next = dir_path.find_first_of("/\\", pos);
+        if (next == std::string_view::npos) {
+            next = dir_path.size();
+        }
+
+        std::string_view name = dir_path.substr(pos, next - pos);
+        if (!name.empty() && name != ".") {
+            current = child(current, name);
+        }
+        pos = next + 1;
+    }
+
+    last_dir_path.assign(dir_path);
+    last_dir = current;
+    return current;
+}
+
+void ArchiveIndexBuilder::push_record(DirId dir, uint32_t name_offset, size_t name_length, const EntryRecord& record) {
+    staged.offsets.push_back(record.offset);
+    staged.sizes.push_back(record.size);
+    staged.crcs.push_back(record.crc);
+    staged.preload_offsets.push_back(record.preload_offset);
+    staged.preload_sizes.push_back(record.preload_size);
+    staged.archive_indices.push_back(record.archive_index);
+    staged.storages.push_back(record.storage);
+    staged.name_offsets.push_back(name_offset);
+    staged.name_lengths.push_back(static_cast<uint16_t>(std::min(name_length, MAX_NAME_LENGTH)));
+    staged.entry_dirs.push_back(dir);
+    staged.dir_file_counts[dir]++;
+}
+
+void ArchiveIndexBuilder::add(std::string_view path, const EntryRecord& record) {
+    size_t last_slash = path.find_last_of("/\\");
+    DirId dir = ROOT_DIR_ID;
+    std::string_view name = path;
+    if (last_slash != std::string_view::npos) {
+        dir = resolve(path.substr(0, last_slash));
+        name = path.substr(last_slash + 1);
+    }
+
+    uint32_t name_offset = append_name(name);
+    push_record(dir, name_offset, name.size(), record);
+}
+
+void ArchiveIndexBuilder::add(std::string_view dir_path, std::string_view stem, std::string_view extension,
+                              const EntryRecord& record) {
+    DirId dir = dir_path.empty() ? ROOT_DIR_ID : resolve(dir_path);
+
+    uint32_t name_offset = static_cast<uint32_t>(staged.names.size());
+    staged.names.append(stem);
+    if (!extension.empty()) {
+        staged.names += '.';
+        staged.names.append(extension);
+    }
+    size_t name_length = staged.names.size() - name_offset;
+    if (name_length > MAX_NAME_LENGTH) {
+        staged.names.resize(name_offset + MAX_NAME_LENGTH);
+    }
+
+    push_record(dir, name_offset, name_length, record);
+}
+
+ArchiveIndex ArchiveIndexBuilder::finish() {
+    ArchiveIndex& source = staged;
+    const size_t dir_count = source.dir_parents.size();
+    const size_t entry_count = source.offsets.size();
+
+    // The root is always staged; checked anyway so the sizes below cannot wrap
+    if (dir_count == 0) {
+        staged = ArchiveIndex();
+        return ArchiveIndex();
+    }
+
+    // Children of every directory, in creation order
+    std::vector<uint32_t> child_start(dir_count + 1, 0);
+    for (DirId d = 1; d < dir_count; ++d) {
+        child_start[source.dir_parents[d] + 1]++;
+    }
+    for (size_t d = 0; d < dir_count; ++d) {
+        child_start[d + 1] += child_start[d];
+    }
+    std::vector<DirId> child_list(dir_count - 1);
+    std::vector<uint32_t> child_fill(child_start.begin(), child_start.end() - 1);
+    for (DirId d = 1; d < dir_count; ++d) {
+        child_list[child_fill[source.dir_parents[d]]++] = d;
+    }
+
+    // Breadth-first numbering gives every directory a consecutive range of children
+    std::vector<DirId> order;
+    std::vector<DirId> new_id(dir_count);
+    order.reserve(dir_count);
+    order.push_back(ROOT_DIR_ID);
+    for (size_t i = 0; i < order.size(); ++i) {
+        DirId old_id = order[i];
+        new_id[old_id] = static_cast<DirId>(i);
+        for (uint32_t c = child_start[old_id]; c < child_start[old_id + 1]; ++c) {
+            order.push_back(child_list[c]);
+        }
+    }
+
+    ArchiveIndex index;
+    index.dir_name_offsets.resize(dir_count);
+    index.dir_name_lengths.resize(dir_count);
+    index.dir_parents.resize(dir_count);
+    index.dir_first_children.resize(dir_count);
+    index.dir_child_counts.resize(dir_count);
+    index.dir_first_files.resize(dir_count);
+    index.dir_file_counts.resize(dir_count);
+
+    EntryId next_file = 0;
+    for (size_t i = 0; i < dir_count; ++i) {
+        DirId old_id = order[i];
+        uint32_t children_of = child_start[old_id + 1] - child_start[old_id];
+
+        index.dir_name_offsets[i] = source.dir_name_offsets[old_id];
+        index.dir_name_lengths[i] = source.dir_name_lengths[old_id];
+        index.dir_parents[i] = old_id == ROOT_DIR_ID ? INVALID_DIR_ID : new_id[source.dir_parents[old_id]];
+        index.dir_child_counts[i] = children_of;
+        index.dir_first_children[i] = children_of > 0 ? new_id[child_list[child_start[old_id]]] : 0;
+        index.dir_first_files[i] = next_file;
+        index.dir_file_counts[i] = source.dir_file_counts[old_id];
+        next_file += index.dir_file_counts[i];
+    }
+
+    // Stable counting sort of entries by their new directory id
+    std::vector<EntryId> file_fill(index.dir_first_files);
+    std::vector<EntryId> destination(entry_count);
+    for (EntryId e = 0; e < entry_count; ++e) {
+        destination[e] = file_fill[new_id[source.entry_dirs[e]]]++;
+    }
+
+    scatter(source.offsets, destination, index.offsets);
+    scatter(source.sizes, destination, index.sizes);
+    scatter(source.crcs, destination, index.crcs);
+    scatter(source.preload_offsets, destination, index.preload_offsets);
+    scatter(source.preload_sizes, destination, index.preload_sizes);
+    scatter(source.archive_indices, destination, index.archive_indices);
+    scatter(source.storages, destination, index.storages);
+    scatter(source.name_offsets, destination, index.name_offsets);
+    scatter(source.name_lengths, destination, index.name_lengths);
+
+    index.entry_dirs.resize(entry_count);
+    for (EntryId e = 0; e < entry_count; ++e) {
+        index.entry_dirs[destination[e]] = new_id[source.entry_dirs[e]];
+    }
+
+    index.names = std::move(source.names);
+    index.names.shrink_to_fit();
+
+    staged = ArchiveIndex();
+    children.clear();
+    last_dir_path.clear();
+    last_dir = INVALID_DIR_ID;
+
+    return index;
+}
+
+} // namespace unpaker
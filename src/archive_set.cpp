@@ -0,0 +1,238 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "archive_set.hpp"
+#include "path_lookup.hpp"
+#include "random_access_file.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace unpaker {
+
+namespace {
+
+constexpr size_t MIN_SLOTS = 16;
+
+} // namespace
+
+MountId ArchiveSet::mount_archive(const fs::path& path, int32_t priority) {
+    auto archive = std::make_shared<PakParser>(path);
+    if (!archive->parse()) {
+        std::cerr << "[ERROR] ArchiveSet: cannot mount " << path.string() << std::endl;
+        return INVALID_MOUNT_ID;
+    }
+    return mount_archive(std::move(archive), path, priority);
+}
+
+MountId ArchiveSet::mount_archive(std::shared_ptr<const PakParser> archive, const fs::path& path, int32_t priority) {
+    if (!archive || !archive->is_valid()) {
+        std::cerr << "[ERROR] ArchiveSet: cannot mount " << path.string() << std::endl;
+        return INVALID_MOUNT_ID;
+    }
+
+    auto mount = std::make_unique<Mount>();
+    mount->info.path = path;
+    mount->info.priority = priority;
+    mount->info.file_count = static_cast<uint32_t>(archive->get_index().entry_count());
+    mount->archive = std::move(archive);
+
+    std::vector<uint64_t> hashes = PathLookup::hash_entries(mount->archive->get_index());
+    return add_mount(std::move(mount), hashes);
+}
+
+MountId ArchiveSet::mount_directory(const fs::path& directory, int32_t priority) {
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec)) {
+        std::cerr << "[ERROR] ArchiveSet: not a directory: " << directory.string() << std::endl;
+        return INVALID_MOUNT_ID;
+    }
+
+    auto mount = std::make_unique<Mount>();
+    mount->info.path = directory;
+    mount->info.priority = priority;
+    mount->info.is_directory = true;
+
+    fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) continue;
+        uint64_t size = it->file_size(entry_ec);
+        if (entry_ec) continue;
+        mount->loose_files.push_back({it->path().lexically_relative(directory).generic_u8string(), size});
+    }
+    if (ec) {
+        std::cerr << "[ERROR] ArchiveSet: cannot list " << directory.string() << ": " << ec.message() << std::endl;
+    }
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(mount->loose_files.size());
+    for (const auto& file : mount->loose_files) {
+        hashes.push_back(PathLookup::hash_path(file.path));
+    }
+    mount->info.file_count = static_cast<uint32_t>(mount->loose_files.size());
+    return add_mount(std::move(mount), hashes);
+}
+
+MountId ArchiveSet::add_mount(std::unique_ptr<Mount> mount, const std::vector<uint64_t>& hashes) {
+    MountId id = static_cast<MountId>(mounts.size());
+    mounts.push_back(std::move(mount));
+
+    // Only the new source is walked; everything already merged stays in place
+    reserve(hashes.size());
+    for (uint32_t entry = 0; entry < hashes.size(); ++entry) {
+        insert(hashes[entry], ResolvedFile{id, entry});
+    }
+    return id;
+}
+
+void ArchiveSet::reserve(size_t count) {
+    size_t capacity = std::max(slots.size(), MIN_SLOTS);
+    while (capacity < (visible_files + count) * 2) {
+        capacity <<= 1;
+    }
+    if (capacity == slots.size()) {
+        return;
+    }
+
+    // Growing moves slots by their stored hash; no path is rebuilt or compared
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots);
+    slots.assign(capacity, Slot{0, ResolvedFile()});
+    mask = capacity - 1;
+    for (const Slot& slot : old_slots) {
+        if (!slot.file.found()) continue;
+        size_t pos = static_cast<size_t>(slot.hash) & mask;
+        while (slots[pos].file.found()) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = slot;
+    }
+}
+
+void ArchiveSet::insert(uint64_t hash, const ResolvedFile& file) {
+    Mount& incoming = *mounts[file.mount];
+    size_t pos = static_cast<size_t>(hash) & mask;
+
+    while (slots[pos].file.found()) {
+        ResolvedFile& current = slots[pos].file;
+        // Equal 64-bit hashes are nearly always the same path; the paths confirm it
+        if (slots[pos].hash == hash && matches(current, path(file))) {
+            Mount& owner = *mounts[current.mount];
+            if (current.mount != file.mount && incoming.info.priority >= owner.info.priority) {
+                owner.info.visible_count--;
+                incoming.info.visible_count++;
+                current = file;
+            }
+            shadowed_files++;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    slots[pos] = Slot{hash, file};
+    incoming.info.visible_count++;
+    visible_files++;
+}
+
+bool ArchiveSet::matches(const ResolvedFile& file, std::string_view path) const {
+    const Mount& mount = *mounts[file.mount];
+    if (mount.archive) {
+        return PathLookup::matches(mount.archive->get_index(), file.entry, path);
+    }
+    return PathLookup::same_path(mount.loose_files[file.entry].path, path);
+}
+
+ResolvedFile ArchiveSet::resolve(std::string_view path) const {
+    if (slots.empty()) {
+        return ResolvedFile();
+    }
+
+    uint64_t hash = PathLookup::hash_path(path);
+    size_t pos = static_cast<size_t>(hash) & mask;
+    while (slots[pos].file.found()) {
+        if (slots[pos].hash == hash && matches(slots[pos].file, path)) {
+            return slots[pos].file;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return ResolvedFile();
+}
+
+std::string ArchiveSet::path(const ResolvedFile& file) const {
+    if (!file.found()) {
+        return std::string();
+    }
+    const Mount& mount = *mounts[file.mount];
+    return mount.archive ? mount.archive->get_index().path(file.entry) : mount.loose_files[file.entry].path;
+}
+
+uint64_t ArchiveSet::size(const ResolvedFile& file) const {
+    if (!file.found()) {
+        return 0;
+    }
+    const Mount& mount = *mounts[file.mount];
+    return mount.archive ? mount.archive->get_index().size(file.entry) : mount.loose_files[file.entry].size;
+}
+
+bool ArchiveSet::extract(std::string_view path, std::vector<uint8_t>& data) const {
+    return extract(resolve(path), data);
+}
+
+bool ArchiveSet::extract(const ResolvedFile& file, std::vector<uint8_t>& data) const {
+    if (!file.found()) {
+        return false;
+    }
+
+    const Mount& mount = *mounts[file.mount];
+    if (mount.archive) {
+        return mount.archive->extract_entry(file.entry, data);
+    }
+
+    const LooseFile& loose = mount.loose_files[file.entry];
+    RandomAccessFile handle;
+    if (!handle.open(mount.info.path / fs::u8path(loose.path))) {
+        std::cerr << "[ERROR] ArchiveSet: cannot open " << loose.path << std::endl;
+        return false;
+    }
+
+    try {
+        data.resize(static_cast<size_t>(handle.size()));
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[ERROR] ArchiveSet: out of memory reading " << loose.path << std::endl;
+        return false;
+    }
+    return handle.read_at(0, data.data(), data.size()) == data.size();
+}
+
+EntryStream ArchiveSet::open(std::string_view path) const {
+    return open(resolve(path));
+}
+
+EntryStream ArchiveSet::open(const ResolvedFile& file) const {
+    if (!file.found()) {
+        return EntryStream();
+    }
+
+    const Mount& mount = *mounts[file.mount];
+    if (mount.archive) {
+        return mount.archive->open_entry(file.entry);
+    }
+
+    auto handle = std::make_shared<RandomAccessFile>();
+    if (!handle->open(mount.info.path / fs::u8path(mount.loose_files[file.entry].path))) {
+        return EntryStream();
+    }
+    uint64_t length = handle->size();
+    return EntryStream({EntrySegment::from_file(std::move(handle), 0, length)});
+}
+
+void ArchiveSet::for_each(const std::function<void(const ResolvedFile& file)>& visit) const {
+    for (const Slot& slot : slots) {
+        if (slot.file.found()) {
+            visit(slot.file);
+        }
+    }
+}
+
+} // namespace unpaker
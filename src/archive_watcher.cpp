@@ -0,0 +1,329 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "archive_watcher.hpp"
+#include "ascii.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace unpaker {
+
+namespace {
+
+// Longest a notification wait runs before looking at the stop flag again
+constexpr uint32_t STOP_CHECK_MS = 100;
+
+std::string lower_ascii(std::string text) {
+    for (char& c : text) {
+        c = fold_ascii(c);
+    }
+    return text;
+}
+
+fs::path parent_directory(const fs::path& archive_path) {
+    fs::path dir = archive_path.parent_path();
+    return dir.empty() ? fs::path(".") : dir;
+}
+
+} // namespace
+
+ArchiveWatcher::ArchiveWatcher(const fs::path& archive_path, const WatchOptions& options)
+    : archive_path(archive_path), options(options) {
+}
+
+ArchiveWatcher::~ArchiveWatcher() {
+    stop();
+}
+
+std::vector<fs::path> ArchiveWatcher::watched_files(const fs::path& archive_path) {
+    std::vector<fs::path> files{archive_path};
+
+    // Same naming rule as the VPK volume table: <prefix>_dir.<ext> keeps its data in <prefix>_NNN.<ext>
+    std::string stem = lower_ascii(archive_path.stem().string());
+    const std::string dir_suffix = "_dir";
+    if (stem.size() <= dir_suffix.size() || stem.compare(stem.size() - dir_suffix.size(), dir_suffix.size(), dir_suffix) != 0) {
+        return files;
+    }
+    std::string prefix = stem.substr(0, stem.size() - dir_suffix.size()) + "_";
+    std::string extension = lower_ascii(archive_path.extension().string());
+
+    std::error_code ec;
+    for (fs::directory_iterator it(parent_directory(archive_path), ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) continue;
+
+        const fs::path& path = it->path();
+        std::string volume_stem = lower_ascii(path.stem().string());
+        if (lower_ascii(path.extension().string()) != extension ||
+            volume_stem.size() <= prefix.size() || volume_stem.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        std::string digits = volume_stem.substr(prefix.size());
+        if (digits.size() <= 5 && std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            files.push_back(path);
+        }
+    }
+
+    std::sort(files.begin() + 1, files.end());
+    return files;
+}
+
+ArchiveWatcher::Stamps ArchiveWatcher::take_stamps() const {
+    Stamps stamps;
+    for (const auto& path : watched_files(archive_path)) {
+        std::error_code ec;
+        FileStamp stamp;
+        stamp.path = path;
+        stamp.size = fs::file_size(path, ec);
+        if (ec) continue;
+        auto mtime = fs::last_write_time(path, ec);
+        if (ec) continue;
+        stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+        stamps.push_back(std::move(stamp));
+    }
+    return stamps;
+}
+
+std::shared_ptr<const PakParser> ArchiveWatcher::parse() const {
+    auto parser = std::make_shared<PakParser>(archive_path);
+    parser->set_index_cache_enabled(options.index_cache);
+    parser->set_thread_count(options.thread_count);
+    // Patchers may rewrite or truncate the files in place while this snapshot is still being read
+    parser->set_pin_files(true);
+    if (!parser->parse()) {
+        return nullptr;
+    }
+    return parser;
+}
+
+std::shared_ptr<const PakParser> ArchiveWatcher::snapshot() const {
+    for (;;) {
+        Slot* slot = current.load();
+        if (!slot) {
+            return nullptr;
+        }
+        // Pin the slot, then make sure it was not swapped out before the pin landed
+        slot->readers.fetch_add(1);
+        if (current.load() == slot) {
+            std::shared_ptr<const PakParser> parser = slot->parser;
+            slot->readers.fetch_sub(1);
+            return parser;
+        }
+        slot->readers.fetch_sub(1);
+    }
+}
+
+void ArchiveWatcher::publish(std::shared_ptr<const PakParser> parser) {
+    Slot* old_slot = current.load();
+    Slot* next_slot = old_slot == &slots[0] ? &slots[1] : &slots[0];
+
+    // Readers still pinning the spare slot saw it was not current and are backing out
+    while (next_slot->readers.load() != 0) {
+        std::this_thread::yield();
+    }
+    next_slot->parser = std::move(parser);
+    current.store(next_slot);
+    published.fetch_add(1);
+
+    // Anyone who pins the old slot from here on finds it is no longer current and never reads it,
+    // so once the pins drain its parser can go. In-flight work holds its own reference and keeps
+    // reading the old files through the handles the parser pinned, until the last reference drops.
+    if (old_slot) {
+        while (old_slot->readers.load() != 0) {
+            std::this_thread::yield();
+        }
+        old_slot->parser.reset();
+    }
+}
+
+bool ArchiveWatcher::start(ReloadCallback callback) {
+    if (worker.joinable()) {
+        return true;
+    }
+
+    on_reload = std::move(callback);
+    stopping = false;
+
+    // Stamps come first so that a change landing during the parse is picked up afterwards
+    Stamps stamps = take_stamps();
+    std::shared_ptr<const PakParser> parser = parse();
+    if (!parser) {
+        Logger::instance().error("Watch: Failed to parse archive: " + archive_path.string());
+        return false;
+    }
+    publish(std::move(parser));
+
+    notifications = open_notifications();
+    if (!notifications) {
+        LOG_DEBUG("Watch: No change notifications for " + parent_directory(archive_path).string() +
+                  ", polling every " + std::to_string(options.poll_ms) + "ms");
+    }
+
+    Logger::instance().info("Watch: Watching " + archive_path.filename().string() + " (" +
+                            std::to_string(stamps.size()) + " files)");
+    worker = std::thread([this, stamps]() { watch_loop(stamps); });
+    return true;
+}
+
+void ArchiveWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake_cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    close_notifications();
+}
+
+void ArchiveWatcher::watch_loop(Stamps known) {
+    // Files that failed to parse are not retried until they change again
+    Stamps rejected;
+
+    while (!stopping) {
+        wait_for_change(options.poll_ms);
+        if (stopping) break;
+
+        Stamps seen = take_stamps();
+        if (seen == known || seen == rejected) continue;
+
+        // Wait for the files to settle so a half-applied patch is never parsed
+        for (;;) {
+            if (!sleep_for(options.settle_ms)) return;
+            Stamps again = take_stamps();
+            if (again == seen) break;
+            seen = std::move(again);
+        }
+        if (seen == known) continue;
+
+        std::shared_ptr<const PakParser> parser = parse();
+        if (!parser) {
+            std::cerr << "[WARNING] Watch: Changed archive failed to parse, keeping the previous snapshot: "
+                      << archive_path.string() << std::endl;
+            rejected = std::move(seen);
+            continue;
+        }
+
+        known = std::move(seen);
+        rejected.clear();
+        publish(parser);
+        Logger::instance().info("Watch: Reloaded " + archive_path.filename().string() + " (" +
+                                std::to_string(parser->get_file_count()) + " files, snapshot " +
+                                std::to_string(published.load()) + ")");
+        if (on_reload) {
+            on_reload(parser);
+        }
+    }
+}
+
+bool ArchiveWatcher::sleep_for(uint32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    wake_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return stopping.load(); });
+    return !stopping;
+}
+
+bool ArchiveWatcher::open_notifications() {
+    fs::path dir = parent_directory(archive_path);
+#ifdef _WIN32
+    HANDLE handle = FindFirstChangeNotificationW(
+        dir.wstring().c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    change_handle = handle;
+    return true;
+#elif defined(__linux__)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+    if (inotify_add_watch(fd, dir.c_str(), mask) < 0) {
+        ::close(fd);
+        return false;
+    }
+    inotify_fd = fd;
+    return true;
+#else
+    (void)dir;
+    return false;
+#endif
+}
+
+void ArchiveWatcher::close_notifications() {
+#ifdef _WIN32
+    if (change_handle) {
+        FindCloseChangeNotification(static_cast<HANDLE>(change_handle));
+        change_handle = nullptr;
+    }
+#else
+    if (inotify_fd >= 0) {
+        ::close(inotify_fd);
+        inotify_fd = -1;
+    }
+#endif
+    notifications = false;
+}
+
+void ArchiveWatcher::wait_for_change(uint32_t timeout_ms) {
+    if (!notifications) {
+        sleep_for(timeout_ms);
+        return;
+    }
+
+    // Events only say something in the directory moved; the stamps decide whether it was ours
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!stopping) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) return;
+        uint32_t slice = static_cast<uint32_t>(std::min<int64_t>(remaining.count(), STOP_CHECK_MS));
+
+#ifdef _WIN32
+        DWORD status = WaitForSingleObject(static_cast<HANDLE>(change_handle), slice);
+        if (status == WAIT_OBJECT_0) {
+            FindNextChangeNotification(static_cast<HANDLE>(change_handle));
+            return;
+        }
+        if (status != WAIT_TIMEOUT) {
+            close_notifications();
+            sleep_for(static_cast<uint32_t>(remaining.count()));
+            return;
+        }
+#elif defined(__linux__)
+        pollfd descriptor = {inotify_fd, POLLIN, 0};
+        int ready = ::poll(&descriptor, 1, static_cast<int>(slice));
+        if (ready > 0) {
+            alignas(inotify_event) char events[4096];
+            while (::read(inotify_fd, events, sizeof(events)) > 0) {
+            }
+            return;
+        }
+        if (ready < 0 && errno != EINTR) {
+            close_notifications();
+            sleep_for(static_cast<uint32_t>(remaining.count()));
+            return;
+        }
+#else
+        sleep_for(slice);
+#endif
+    }
+}
+
+} // namespace unpaker
@@ -0,0 +1,325 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "async_reader.hpp"
+#include "logger.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+
+#ifdef UNPAKER_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#endif
+
+namespace unpaker {
+
+#ifdef UNPAKER_IO_URING
+
+namespace {
+
+constexpr uint32_t MAX_QUEUE_DEPTH = 4096;
+
+// Linux UIO_MAXIOV; a request with more slices is queued as several reads
+constexpr size_t MAX_IO_SLICES = 1024;
+
+// A queued read covering part of one request
+struct RingRead {
+    size_t request;
+    uint64_t offset;
+    size_t first_iovec;
+    size_t iovec_count;
+    size_t length;
+};
+
+int io_uring_setup(uint32_t entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+} // namespace
+
+// Shared submission and completion rings. This thread is the only producer of submissions and
+// the only consumer of completions, so only the indices the kernel also touches need atomics.
+struct AsyncReader::Ring {
+    int fd = -1;
+
+    void* sq_ring = nullptr;
+    size_t sq_ring_size = 0;
+    void* cq_ring = nullptr;
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+
+    ~Ring() {
+        if (sqes) munmap(sqes, sqes_size);
+        if (cq_ring && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+        if (sq_ring) munmap(sq_ring, sq_ring_size);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+bool AsyncReader::setup_ring(uint32_t entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    auto ring = std::make_unique<Ring>();
+    ring->fd = io_uring_setup(entries, &params);
+    if (ring->fd < 0) {
+        DEBUG_CERR("[DEBUG] AsyncReader: io_uring_setup failed: " << std::strerror(errno) << std::endl);
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mapping) {
+        ring->sq_ring_size = ring->cq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+    }
+
+    void* sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) return false;
+    ring->sq_ring = sq_ring;
+
+    if (single_mapping) {
+        ring->cq_ring = sq_ring;
+    } else {
+        void* cq_ring = mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring->fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) return false;
+        ring->cq_ring = cq_ring;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    uint8_t* sq = static_cast<uint8_t*>(ring->sq_ring);
+    ring->sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+
+    uint8_t* cq = static_cast<uint8_t*>(ring->cq_ring);
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring->cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+
+    ring_ = ring.release();
+    return true;
+}
+
+void AsyncReader::read_all_ring(std::vector<ReadRequest>& requests) {
+    Ring& ring = *ring_;
+
+    std::vector<iovec> iovecs;
+    std::vector<RingRead> reads;
+    for (size_t r = 0; r < requests.size(); ++r) {
+        ReadRequest& request = requests[r];
+        request.bytes_read = 0;
+
+        uint64_t offset = request.offset;
+        for (size_t first = 0; first < request.slice_count; first += MAX_IO_SLICES) {
+            size_t count = std::min(MAX_IO_SLICES, request.slice_count - first);
+            RingRead read{r, offset, iovecs.size(), count, 0};
+            for (size_t s = first; s < first + count; ++s) {
+                iovecs.push_back({request.slices[s].data, request.slices[s].length});
+                read.length += request.slices[s].length;
+            }
+            offset += read.length;
+            reads.push_back(read);
+        }
+    }
+
+    // Requests with a short or failed read are redone synchronously, which also settles reads
+    // that legitimately stop at end of file
+    std::vector<uint8_t> incomplete(requests.size(), 0);
+    std::vector<uint8_t> completed(reads.size(), 0);
+    size_t next = 0;
+    size_t in_flight = 0;
+
+    auto reap = [&]() {
+        unsigned head = *ring.cq_head;
+        unsigned completed_tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != completed_tail; ++head) {
+            const io_uring_cqe& cqe = ring.cqes[head & ring.cq_mask];
+            size_t index = static_cast<size_t>(cqe.user_data);
+            const RingRead& read = reads[index];
+            completed[index] = 1;
+            if (cqe.res >= 0 && static_cast<size_t>(cqe.res) == read.length) {
+                requests[read.request].bytes_read += read.length;
+            } else {
+                incomplete[read.request] = 1;
+            }
+            --in_flight;
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    };
+
+    bool ring_failed = false;
+    while (next < reads.size() || in_flight > 0) {
+        unsigned tail = *ring.sq_tail;
+        while (next < reads.size() && in_flight < ring.sq_entries) {
+            const RingRead& read = reads[next];
+            const RandomAccessFile* file = requests[read.request].file;
+            if (!file || file->descriptor() < 0) {
+                completed[next] = 1;
+                incomplete[read.request] = 1;
+                ++next;
+                continue;
+            }
+
+            unsigned slot = tail & ring.sq_mask;
+            io_uring_sqe& sqe = ring.sqes[slot];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = file->descriptor();
+            sqe.off = read.offset;
+            sqe.addr = reinterpret_cast<uint64_t>(iovecs.data() + read.first_iovec);
+            sqe.len = static_cast<uint32_t>(read.iovec_count);
+            sqe.user_data = next;
+            ring.sq_array[slot] = slot;
+
+            ++tail;
+            ++next;
+            ++in_flight;
+        }
+        __atomic_store_n(ring.sq_tail, tail, __ATOMIC_RELEASE);
+
+        if (in_flight == 0) {
+            continue;
+        }
+
+        unsigned to_submit = tail - __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE);
+        if (io_uring_enter(ring.fd, to_submit, 1, IORING_ENTER_GETEVENTS) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            std::cerr << "[ERROR] AsyncReader: io_uring_enter failed: " << std::strerror(errno) << std::endl;
+            ring_failed = true;
+            break;
+        }
+        reap();
+    }
+
+    if (ring_failed) {
+        // Entries the kernel has not picked up yet are taken back and never run. The ones it did
+        // pick up still write into the caller's buffers, so wait for every one of them to post its
+        // completion before anything is read again; completions land in the mapped ring whether
+        // or not io_uring_enter works, so a failing enter only means polling the tail instead.
+        unsigned head = __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE);
+        in_flight -= *ring.sq_tail - head;
+        __atomic_store_n(ring.sq_tail, head, __ATOMIC_RELEASE);
+
+        while (in_flight > 0) {
+            reap();
+            if (in_flight == 0) break;
+            if (io_uring_enter(ring.fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                usleep(1000);
+            }
+        }
+
+        // Everything not yet completed is read again below; later batches use the pool
+        delete ring_;
+        ring_ = nullptr;
+        backend_ = Backend::THREAD_POOL;
+    }
+
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (!completed[i]) {
+            incomplete[reads[i].request] = 1;
+        }
+    }
+
+    for (size_t r = 0; r < requests.size(); ++r) {
+        ReadRequest& request = requests[r];
+        if (incomplete[r]) {
+            request.bytes_read = request.file
+                ? request.file->read_vectored(request.offset, request.slices, request.slice_count)
+                : 0;
+        }
+    }
+}
+
+#endif
+
+AsyncReader::AsyncReader(uint32_t queue_depth, uint32_t thread_count) : thread_count_(thread_count) {
+#ifdef UNPAKER_IO_URING
+    if (setup_ring(std::clamp<uint32_t>(queue_depth, 1, MAX_QUEUE_DEPTH))) {
+        backend_ = Backend::IO_URING;
+    }
+#else
+    (void)queue_depth;
+#endif
+}
+
+AsyncReader::~AsyncReader() {
+#ifdef UNPAKER_IO_URING
+    delete ring_;
+#endif
+}
+
+const char* AsyncReader::backend_name() const {
+    return backend_ == Backend::IO_URING ? "io_uring" : "thread pool";
+}
+
+void AsyncReader::read_all(std::vector<ReadRequest>& requests) {
+    if (requests.empty()) return;
+
+#ifdef UNPAKER_IO_URING
+    if (backend_ == Backend::IO_URING) {
+        read_all_ring(requests);
+        return;
+    }
+#endif
+    read_all_pool(requests);
+}
+
+void AsyncReader::read_all_pool(std::vector<ReadRequest>& requests) {
+    auto read_one = [&requests](size_t i) {
+        ReadRequest& request = requests[i];
+        request.bytes_read = request.file
+            ? request.file->read_vectored(request.offset, request.slices, request.slice_count)
+            : 0;
+    };
+
+    size_t workers = std::min(ThreadPool::resolve_thread_count(thread_count_), requests.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            read_one(i);
+        }
+        return;
+    }
+
+    // The calling thread takes part in parallel_for, so the pool needs one fewer worker
+    size_t helpers = ThreadPool::resolve_thread_count(thread_count_) - 1;
+    if (!pool_ || pool_->size() != helpers) {
+        pool_ = std::make_unique<ThreadPool>(helpers);
+    }
+    pool_->parallel_for(requests.size(), read_one);
+}
+
+} // namespace unpaker
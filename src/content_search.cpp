@@ -0,0 +1,430 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "content_search.hpp"
+#include "ascii.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <regex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNPAKER_GREP_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace unpaker {
+
+namespace {
+
+// Bytes read from an entry per step
+constexpr size_t SEARCH_CHUNK_SIZE = 1024 * 1024;
+// Longest partial line carried into the next step; longer lines are cut and lose context
+constexpr size_t MAX_CARRIED_LINE = 64 * 1024;
+// Work unit: a run of one volume's entries in offset order
+constexpr uint64_t SEARCH_TASK_BYTES = 64 * 1024 * 1024;
+
+constexpr size_t NO_MATCH = static_cast<size_t>(-1);
+
+inline uint8_t other_case(uint8_t c) {
+    if (c >= 'a' && c <= 'z') return static_cast<uint8_t>(c - ('a' - 'A'));
+    if (c >= 'A' && c <= 'Z') return static_cast<uint8_t>(c + ('a' - 'A'));
+    return c;
+}
+
+#ifdef UNPAKER_GREP_SSE2
+inline size_t count_trailing_zeros(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctz(value));
+#endif
+}
+#endif
+
+// Finds one literal. The SSE2 path compares 16 candidate positions at once against the first
+// and last byte of the literal, in both cases when case is ignored, and only positions where
+// both agree are compared in full.
+class LiteralScanner {
+public:
+    LiteralScanner(const std::string& literal, bool ignore_case)
+        : ignore_case(ignore_case) {
+        for (char c : literal) {
+            uint8_t byte = static_cast<uint8_t>(c);
+            needle.push_back(ignore_case ? fold_ascii(byte) : byte);
+        }
+    }
+
+    size_t length() const { return needle.size(); }
+
+    // First occurrence starting in [from, size), or NO_MATCH
+    size_t find(const uint8_t* data, size_t size, size_t from) const {
+        const size_t length = needle.size();
+        if (length == 0 || size < length) return NO_MATCH;
+        const size_t last_start = size - length;
+        size_t pos = from;
+
+#ifdef UNPAKER_GREP_SSE2
+        const uint8_t first = needle.front();
+        const uint8_t last = needle.back();
+        const __m128i first_a = _mm_set1_epi8(static_cast<char>(first));
+        const __m128i first_b = _mm_set1_epi8(static_cast<char>(ignore_case ? other_case(first) : first));
+        const __m128i last_a = _mm_set1_epi8(static_cast<char>(last));
+        const __m128i last_b = _mm_set1_epi8(static_cast<char>(ignore_case ? other_case(last) : last));
+
+        while (pos + 16 <= last_start + 1) {
+            __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + length - 1));
+            __m128i head_eq = _mm_or_si128(_mm_cmpeq_epi8(head, first_a), _mm_cmpeq_epi8(head, first_b));
+            __m128i tail_eq = _mm_or_si128(_mm_cmpeq_epi8(tail, last_a), _mm_cmpeq_epi8(tail, last_b));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(head_eq, tail_eq)));
+            while (mask != 0) {
+                size_t candidate = pos + count_trailing_zeros(mask);
+                if (equals(data + candidate)) {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+            pos += 16;
+        }
+#endif
+
+        for (; pos <= last_start; ++pos) {
+            if (equals(data + pos)) {
+                return pos;
+            }
+        }
+        return NO_MATCH;
+    }
+
+private:
+    bool equals(const uint8_t* text) const {
+        if (!ignore_case) {
+            return std::memcmp(text, needle.data(), needle.size()) == 0;
+        }
+        for (size_t i = 0; i < needle.size(); ++i) {
+            if (fold_ascii(text[i]) != needle[i]) return false;
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> needle;
+    bool ignore_case;
+};
+
+struct SearchTask {
+    std::vector<EntryId> entries;
+};
+
+struct TaskResult {
+    std::vector<SearchMatch> matches;
+    uint32_t searched = 0;
+    uint32_t matched = 0;
+    uint32_t failed = 0;
+    uint64_t bytes = 0;
+};
+
+// Scans one entry. The buffer always starts at a line start (or mid-line after an overlong line),
+// so every hit can be reported with the line around it.
+class EntryScanner {
+public:
+    EntryScanner(const std::vector<LiteralScanner>& scanners, const std::regex* regex, const SearchOptions& options)
+        : scanners(scanners), regex(regex), options(options), next_hits(scanners.size()) {
+        for (const auto& scanner : scanners) {
+            overlap = std::max(overlap, scanner.length() > 0 ? scanner.length() - 1 : 0);
+        }
+        buffer.resize(SEARCH_CHUNK_SIZE + MAX_CARRIED_LINE);
+    }
+
+    // Returns false if the entry could not be read to the end
+    bool scan(EntryStream& stream, EntryId id, std::vector<SearchMatch>& matches, uint64_t& bytes) {
+        entry = id;
+        reported = 0;
+        found = &matches;
+        size_t carried = 0;
+        base_offset = 0;
+        base_line = 1;
+
+        while (true) {
+            size_t got = stream.read(buffer.data() + carried, SEARCH_CHUNK_SIZE);
+            size_t filled = carried + got;
+            bytes += got;
+            bool last = got == 0 || stream.eof() || stream.failed();
+
+            size_t cut = filled;
+            if (!last) {
+                size_t newline = filled;
+                while (newline > 0 && buffer[newline - 1] != '\n') --newline;
+                cut = newline;
+                if (cut == 0 || filled - cut > MAX_CARRIED_LINE) {
+                    // No usable line end: keep only enough bytes for a literal starting in the
+                    // carried tail; one starting before the cut is found in this pass
+                    cut = filled - std::min(filled, overlap);
+                }
+            }
+
+            if (!scan_region(cut, filled) && !last) {
+                // The per-entry limit was reached; the rest of the entry does not matter
+                return true;
+            }
+
+            base_line += static_cast<uint32_t>(std::count(buffer.begin(), buffer.begin() + cut, '\n'));
+            base_offset += cut;
+            std::memmove(buffer.data(), buffer.data() + cut, filled - cut);
+            carried = filled - cut;
+
+            if (last) {
+                return !stream.failed();
+            }
+        }
+    }
+
+private:
+    // Reports hits starting in buffer[0, limit), reading up to size so that a hit may run past
+    // limit; false once the per-entry limit is reached
+    bool scan_region(size_t limit, size_t size) {
+        const uint8_t* data = buffer.data();
+        size_t pos = 0;
+        size_t line_pos = 0;
+        uint32_t line = base_line;
+
+        if (scanners.empty()) {
+            // Regex alone: every line is a candidate
+            while (pos < limit) {
+                size_t end = line_end(data, size, pos);
+                std::cmatch match;
+                const char* first = reinterpret_cast<const char*>(data + pos);
+                if (std::regex_search(first, first + (end - pos), match, *regex)) {
+                    line += static_cast<uint32_t>(std::count(data + line_pos, data + pos, '\n'));
+                    line_pos = pos;
+                    if (!report(data, size, pos + static_cast<size_t>(match.position(0)),
+                                static_cast<size_t>(match.length(0)), line)) {
+                        return false;
+                    }
+                }
+                pos = end + 1;
+            }
+            return true;
+        }
+
+        for (size_t k = 0; k < scanners.size(); ++k) {
+            next_hits[k] = scanners[k].find(data, size, 0);
+        }
+
+        while (pos < size) {
+            size_t hit = NO_MATCH;
+            size_t hit_length = 0;
+            for (size_t k = 0; k < scanners.size(); ++k) {
+                if (next_hits[k] != NO_MATCH && next_hits[k] < pos) {
+                    next_hits[k] = scanners[k].find(data, size, pos);
+                }
+                if (next_hits[k] < hit) {
+                    hit = next_hits[k];
+                    hit_length = scanners[k].length();
+                }
+            }
+            if (hit == NO_MATCH || hit >= limit) {
+                break;
+            }
+
+            size_t start = line_start(data, hit);
+            size_t end = line_end(data, size, hit);
+            pos = end + 1;
+
+            if (regex) {
+                std::cmatch match;
+                const char* first = reinterpret_cast<const char*>(data + start);
+                if (!std::regex_search(first, first + (end - start), match, *regex)) {
+                    continue;
+                }
+            }
+
+            line += static_cast<uint32_t>(std::count(data + line_pos, data + hit, '\n'));
+            line_pos = hit;
+            if (!report(data, size, hit, hit_length, line)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static size_t line_start(const uint8_t* data, size_t pos) {
+        while (pos > 0 && data[pos - 1] != '\n') --pos;
+        return pos;
+    }
+
+    static size_t line_end(const uint8_t* data, size_t size, size_t pos) {
+        const void* newline = std::memchr(data + pos, '\n', size - pos);
+        return newline ? static_cast<size_t>(static_cast<const uint8_t*>(newline) - data) : size;
+    }
+
+    bool report(const uint8_t* data, size_t size, size_t hit, size_t length, uint32_t line) {
+        size_t start = line_start(data, hit);
+        size_t end = line_end(data, size, hit);
+        size_t from = hit - std::min<size_t>(hit - start, options.context_bytes);
+        size_t to = std::min(end, hit + length + options.context_bytes);
+
+        SearchMatch match;
+        match.entry = entry;
+        match.offset = base_offset + hit;
+        match.line = line;
+        match.context.reserve(to - from);
+        for (size_t i = from; i < to; ++i) {
+            uint8_t c = data[i];
+            if (c == '\r') continue;
+            match.context += (c == '\t' || c >= 32) ? static_cast<char>(c) : '.';
+        }
+        found->push_back(std::move(match));
+
+        ++reported;
+        return options.max_matches_per_entry == 0 || reported < options.max_matches_per_entry;
+    }
+
+    const std::vector<LiteralScanner>& scanners;
+    const std::regex* regex;
+    const SearchOptions& options;
+    std::vector<size_t> next_hits;
+    std::vector<uint8_t> buffer;
+    size_t overlap = 0;
+
+    EntryId entry = INVALID_ENTRY_ID;
+    std::vector<SearchMatch>* found = nullptr;
+    uint32_t reported = 0;
+    uint64_t base_offset = 0;
+    uint32_t base_line = 1;
+};
+
+} // namespace
+
+SearchResult ContentSearch::search(const PakParser& parser, const SearchOptions& options) {
+    std::vector<EntryId> entries(parser.get_index().entry_count());
+    for (EntryId id = 0; id < entries.size(); ++id) {
+        entries[id] = id;
+    }
+    return search(parser, entries, options);
+}
+
+SearchResult ContentSearch::search(const PakParser& parser, const std::vector<EntryId>& entries,
+                                   const SearchOptions& options) {
+    SearchResult result;
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<LiteralScanner> scanners;
+    for (const auto& literal : options.literals) {
+        if (!literal.empty()) {
+            scanners.emplace_back(literal, options.ignore_case);
+        }
+    }
+
+    std::regex regex;
+    bool has_regex = !options.regex.empty();
+    if (has_regex) {
+        try {
+            auto flags = std::regex::ECMAScript | std::regex::optimize;
+            if (options.ignore_case) flags |= std::regex::icase;
+            regex = std::regex(options.regex, flags);
+        } catch (const std::regex_error& e) {
+            std::cerr << "[ERROR] Invalid search regex: " << e.what() << std::endl;
+            return result;
+        }
+    }
+
+    if (scanners.empty() && !has_regex) {
+        std::cerr << "[ERROR] Nothing to search for" << std::endl;
+        return result;
+    }
+
+    // Group by data volume and sort by offset so each task reads its volume front to back
+    const ArchiveIndex& index = parser.get_index();
+    const auto& volumes = index.archive_index_column();
+    const auto& offsets = index.offset_column();
+    std::map<uint16_t, std::vector<EntryId>> by_volume;
+    for (EntryId id : entries) {
+        if (id < index.entry_count()) {
+            by_volume[volumes[id]].push_back(id);
+        }
+    }
+
+    std::vector<SearchTask> tasks;
+    for (auto& [volume, ids] : by_volume) {
+        std::sort(ids.begin(), ids.end(), [&](EntryId a, EntryId b) { return offsets[a] < offsets[b]; });
+        uint64_t task_bytes = SEARCH_TASK_BYTES;
+        for (EntryId id : ids) {
+            if (task_bytes >= SEARCH_TASK_BYTES) {
+                tasks.emplace_back();
+                task_bytes = 0;
+            }
+            tasks.back().entries.push_back(id);
+            task_bytes += index.size(id);
+        }
+    }
+
+    std::vector<TaskResult> results(tasks.size());
+    auto run_task = [&](size_t t) {
+        TaskResult& task_result = results[t];
+        EntryScanner scanner(scanners, has_regex ? &regex : nullptr, options);
+        for (EntryId id : tasks[t].entries) {
+            EntryStream stream = parser.open_entry(id);
+            size_t before = task_result.matches.size();
+            task_result.searched++;
+            if (!stream.is_open() || !scanner.scan(stream, id, task_result.matches, task_result.bytes)) {
+                task_result.failed++;
+            }
+            if (task_result.matches.size() > before) {
+                task_result.matched++;
+            }
+        }
+    };
+
+    ThreadPool::run(tasks.size(), options.thread_count, run_task);
+
+    for (auto& task_result : results) {
+        result.entries_searched += task_result.searched;
+        result.entries_matched += task_result.matched;
+        result.entries_failed += task_result.failed;
+        result.bytes_searched += task_result.bytes;
+        std::move(task_result.matches.begin(), task_result.matches.end(), std::back_inserter(result.matches));
+    }
+
+    std::sort(result.matches.begin(), result.matches.end(), [](const SearchMatch& a, const SearchMatch& b) {
+        return a.entry != b.entry ? a.entry < b.entry : a.offset < b.offset;
+    });
+
+    // Paths are only built for entries that matched
+    EntryId path_entry = INVALID_ENTRY_ID;
+    std::string path;
+    for (auto& match : result.matches) {
+        if (match.entry != path_entry) {
+            path_entry = match.entry;
+            path = index.path(match.entry);
+        }
+        match.path = path;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+void ContentSearch::write_text(std::ostream& out, const SearchResult& result) {
+    for (const auto& match : result.matches) {
+        out << match.path << ':' << match.line << ':' << match.offset << ": " << match.context << '\n';
+    }
+    out << result.matches.size() << " matches in " << result.entries_matched << " of "
+        << result.entries_searched << " entries (" << result.bytes_searched << " bytes searched";
+    if (result.entries_failed > 0) {
+        out << ", " << result.entries_failed << " unreadable";
+    }
+    out << ")\n";
+}
+
+} // namespace unpaker
@@ -0,0 +1,373 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "entry_selector.hpp"
+#include "ascii.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <iostream>
+#include <regex>
+
+namespace unpaker {
+
+namespace {
+
+// Directories are handed to workers in runs of at least this many files
+constexpr size_t SELECT_CHUNK_FILES = 4096;
+
+inline char normalize(char c) {
+    return c == '\\' ? '/' : fold_ascii(c);
+}
+
+enum class TokenKind {
+    LITERAL,
+    ANY_CHAR,
+    CHAR_CLASS,
+    STAR,
+    GLOBSTAR,
+    // "**/": any number of whole directories, including none
+    GLOBSTAR_DIR
+};
+
+struct Token {
+    TokenKind kind;
+    std::string literal;
+    std::bitset<256> chars;
+};
+
+// Compares text, which may be in any case, against an already folded literal of the same length
+inline bool equals_folded(const char* text, const std::string& literal) {
+    for (size_t i = 0; i < literal.size(); ++i) {
+        if (fold_ascii(text[i]) != literal[i]) return false;
+    }
+    return true;
+}
+
+// Paths are matched as stored, with case folded during comparison rather than copied
+bool match_tokens(const Token* token, const Token* end, const char* text, const char* text_end) {
+    for (; token != end; ++token) {
+        switch (token->kind) {
+            case TokenKind::LITERAL: {
+                size_t length = token->literal.size();
+                if (static_cast<size_t>(text_end - text) < length || !equals_folded(text, token->literal)) {
+                    return false;
+                }
+                text += length;
+                break;
+            }
+            case TokenKind::ANY_CHAR:
+                if (text == text_end || *text == '/') return false;
+                ++text;
+                break;
+            case TokenKind::CHAR_CLASS:
+                if (text == text_end || *text == '/' || !token->chars[static_cast<unsigned char>(fold_ascii(*text))]) return false;
+                ++text;
+                break;
+            case TokenKind::STAR:
+                if (token + 1 == end) {
+                    return std::memchr(text, '/', text_end - text) == nullptr;
+                }
+                for (const char* p = text;; ++p) {
+                    // Only positions where a following literal could start are worth trying
+                    bool candidate = token[1].kind != TokenKind::LITERAL ||
+                                     (p != text_end && fold_ascii(*p) == token[1].literal[0]);
+                    if (candidate && match_tokens(token + 1, end, p, text_end)) return true;
+                    if (p == text_end || *p == '/') return false;
+                }
+            case TokenKind::GLOBSTAR:
+                if (token + 1 == end) return true;
+                for (const char* p = text; p <= text_end; ++p) {
+                    if (match_tokens(token + 1, end, p, text_end)) return true;
+                }
+                return false;
+            case TokenKind::GLOBSTAR_DIR:
+                for (const char* p = text;;) {
+                    if (match_tokens(token + 1, end, p, text_end)) return true;
+                    const char* slash = static_cast<const char*>(std::memchr(p, '/', text_end - p));
+                    if (!slash) return false;
+                    p = slash + 1;
+                }
+        }
+    }
+    return text == text_end;
+}
+
+} // namespace
+
+struct EntrySelector::Pattern {
+    bool negated = false;
+    bool is_regex = false;
+    // Globs without '/' see only the file name
+    bool name_only = false;
+    std::vector<Token> tokens;
+    // Literals at either end of a glob are checked directly; tokens[body_begin, body_end) is the rest
+    std::string prefix;
+    std::string suffix;
+    size_t body_begin = 0;
+    size_t body_end = 0;
+    std::regex regex;
+
+    bool matches(std::string_view text) const {
+        if (is_regex) {
+            return std::regex_search(text.begin(), text.end(), regex);
+        }
+
+        size_t anchored = prefix.size() + suffix.size();
+        if (text.size() < anchored ||
+            !equals_folded(text.data(), prefix) ||
+            !equals_folded(text.data() + text.size() - suffix.size(), suffix)) {
+            return false;
+        }
+        if (body_begin > body_end) {
+            // A glob that is one literal is its own prefix and suffix
+            return text.size() == prefix.size();
+        }
+        return match_tokens(tokens.data() + body_begin, tokens.data() + body_end,
+                            text.data() + prefix.size(), text.data() + text.size() - suffix.size());
+    }
+
+    // True if the file name alone already rules out a match of the full path
+    bool rejects_name(std::string_view name) const {
+        if (is_regex || name_only || suffix.find('/') != std::string::npos) return false;
+        return name.size() < suffix.size() || !equals_folded(name.data() + name.size() - suffix.size(), suffix);
+    }
+
+    // False if no file below the directory can match; dir_path ends in '/' unless it is the root
+    bool may_match_directory(std::string_view dir_path) const {
+        if (is_regex || name_only) return true;
+        size_t length = std::min(dir_path.size(), prefix.size());
+        return equals_folded(dir_path.data(), prefix.substr(0, length));
+    }
+};
+
+EntrySelector::EntrySelector() = default;
+EntrySelector::~EntrySelector() = default;
+EntrySelector::EntrySelector(EntrySelector&&) noexcept = default;
+EntrySelector& EntrySelector::operator=(EntrySelector&&) noexcept = default;
+
+bool EntrySelector::add(std::string_view pattern) {
+    auto compiled = std::make_unique<Pattern>();
+    std::string_view source = pattern;
+
+    if (!source.empty() && source[0] == '!') {
+        compiled->negated = true;
+        source.remove_prefix(1);
+    }
+
+    if (source.substr(0, 3) == "re:") {
+        source.remove_prefix(3);
+        try {
+            compiled->regex = std::regex(source.begin(), source.end(),
+                                         std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+        } catch (const std::regex_error& e) {
+            std::cerr << "[ERROR] Invalid pattern " << pattern << ": " << e.what() << std::endl;
+            return false;
+        }
+        compiled->is_regex = true;
+        patterns.push_back(std::move(compiled));
+        return true;
+    }
+
+    std::string glob;
+    for (char c : source) {
+        glob += normalize(c);
+    }
+    // Archive paths are relative, and "./" or "//" never occur in them
+    while (!glob.empty() && glob[0] == '/') glob.erase(0, 1);
+    if (glob.empty()) {
+        std::cerr << "[ERROR] Invalid pattern " << pattern << ": empty" << std::endl;
+        return false;
+    }
+    compiled->name_only = glob.find('/') == std::string::npos;
+
+    auto& tokens = compiled->tokens;
+    for (size_t i = 0; i < glob.size();) {
+        char c = glob[i];
+        if (c == '*') {
+            size_t run_end = glob.find_first_not_of('*', i);
+            size_t run = (run_end == std::string::npos ? glob.size() : run_end) - i;
+            if (run == 1) {
+                tokens.push_back({TokenKind::STAR, {}, {}});
+                i += 1;
+            } else if (i + run < glob.size() && glob[i + run] == '/' && (i == 0 || glob[i - 1] == '/')) {
+                tokens.push_back({TokenKind::GLOBSTAR_DIR, {}, {}});
+                i += run + 1;
+            } else {
+                tokens.push_back({TokenKind::GLOBSTAR, {}, {}});
+                i += run;
+            }
+        } else if (c == '?') {
+            tokens.push_back({TokenKind::ANY_CHAR, {}, {}});
+            ++i;
+        } else if (c == '[') {
+            size_t close = glob.find(']', i + 2);
+            if (close == std::string::npos) {
+                std::cerr << "[ERROR] Invalid pattern " << pattern << ": unterminated '['" << std::endl;
+                return false;
+            }
+            Token token{TokenKind::CHAR_CLASS, {}, {}};
+            size_t j = i + 1;
+            bool negate = glob[j] == '!' || glob[j] == '^';
+            if (negate) ++j;
+            for (; j < close; ++j) {
+                unsigned char low = static_cast<unsigned char>(glob[j]);
+                unsigned char high = low;
+                if (j + 2 < close && glob[j + 1] == '-') {
+                    high = static_cast<unsigned char>(glob[j + 2]);
+                    j += 2;
+                }
+                for (unsigned v = low; v <= high; ++v) {
+                    token.chars.set(v);
+                }
+            }
+            if (negate) token.chars.flip();
+            tokens.push_back(std::move(token));
+            i = close + 1;
+        } else {
+            if (tokens.empty() || tokens.back().kind != TokenKind::LITERAL) {
+                tokens.push_back({TokenKind::LITERAL, {}, {}});
+            }
+            tokens.back().literal += c;
+            ++i;
+        }
+    }
+
+    compiled->body_end = tokens.size();
+    if (tokens.front().kind == TokenKind::LITERAL) {
+        compiled->prefix = tokens.front().literal;
+        compiled->body_begin = 1;
+    }
+    if (tokens.size() > 1 && tokens.back().kind == TokenKind::LITERAL) {
+        compiled->suffix = tokens.back().literal;
+        compiled->body_end = tokens.size() - 1;
+    } else if (tokens.size() == 1 && tokens.back().kind == TokenKind::LITERAL) {
+        compiled->body_end = 0;
+    }
+
+    patterns.push_back(std::move(compiled));
+    return true;
+}
+
+bool EntrySelector::decide(const std::vector<const Pattern*>& active, std::string& path, size_t dir_length,
+                           std::string_view name) const {
+    // The full path is only assembled once a pattern needs more than the name
+    bool path_ready = false;
+    for (auto it = active.rbegin(); it != active.rend(); ++it) {
+        const Pattern& pattern = **it;
+        if (pattern.rejects_name(name)) continue;
+        if (!pattern.name_only && !path_ready) {
+            path.resize(dir_length);
+            path.append(name);
+            path_ready = true;
+        }
+        if (pattern.matches(pattern.name_only ? name : std::string_view(path))) {
+            return !pattern.negated;
+        }
+    }
+    return !patterns.empty() && patterns.front()->negated;
+}
+
+bool EntrySelector::matches(std::string_view path) const {
+    std::string normalized;
+    normalized.reserve(path.size());
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t next = path.find_first_of("/\\", pos);
+        if (next == std::string_view::npos) next = path.size();
+        std::string_view component = path.substr(pos, next - pos);
+        if (!component.empty() && component != ".") {
+            if (!normalized.empty()) normalized += '/';
+            normalized += component;
+        }
+        pos = next + 1;
+    }
+
+    size_t slash = normalized.rfind('/');
+    size_t dir_length = slash == std::string::npos ? 0 : slash + 1;
+    std::string name = normalized.substr(dir_length);
+
+    std::vector<const Pattern*> active;
+    for (const auto& pattern : patterns) {
+        active.push_back(pattern.get());
+    }
+    return decide(active, normalized, dir_length, name);
+}
+
+std::vector<EntryId> EntrySelector::select(const ArchiveIndex& index, uint32_t thread_count) const {
+    std::vector<std::pair<DirId, DirId>> chunks;
+    DirId chunk_begin = 0;
+    size_t chunk_files = 0;
+    for (DirId dir = 0; dir < index.directory_count(); ++dir) {
+        chunk_files += index.file_count(dir);
+        if (chunk_files >= SELECT_CHUNK_FILES) {
+            chunks.push_back({chunk_begin, dir + 1});
+            chunk_begin = dir + 1;
+            chunk_files = 0;
+        }
+    }
+    if (chunk_begin < index.directory_count()) {
+        chunks.push_back({chunk_begin, static_cast<DirId>(index.directory_count())});
+    }
+
+    const bool selected_by_default = !patterns.empty() && patterns.front()->negated;
+    std::vector<std::vector<EntryId>> results(chunks.size());
+
+    auto select_chunk = [&](size_t c) {
+        std::vector<const Pattern*> active;
+        std::string path;
+        auto& selected = results[c];
+
+        for (DirId dir = chunks[c].first; dir < chunks[c].second; ++dir) {
+            EntryId first = index.first_file(dir);
+            uint32_t count = index.file_count(dir);
+            if (count == 0) continue;
+
+            path.clear();
+            if (dir != ROOT_DIR_ID) {
+                path = index.directory_path(dir);
+                std::replace(path.begin(), path.end(), '\\', '/');
+                path += '/';
+            }
+            size_t dir_length = path.size();
+
+            active.clear();
+            for (const auto& pattern : patterns) {
+                if (pattern->may_match_directory(path)) active.push_back(pattern.get());
+            }
+            if (active.empty()) {
+                if (selected_by_default) {
+                    for (EntryId id = first; id < first + count; ++id) selected.push_back(id);
+                }
+                continue;
+            }
+
+            for (EntryId id = first; id < first + count; ++id) {
+                if (decide(active, path, dir_length, index.name(id))) {
+                    selected.push_back(id);
+                }
+            }
+        }
+    };
+
+    ThreadPool::run(chunks.size(), thread_count, select_chunk);
+
+    std::vector<EntryId> selected;
+    for (const auto& part : results) {
+        selected.insert(selected.end(), part.begin(), part.end());
+    }
+    return selected;
+}
+
+void EntrySelector::sort_for_extraction(const ArchiveIndex& index, std::vector<EntryId>& entries) {
+    const auto& volumes = index.archive_index_column();
+    const auto& offsets = index.offset_column();
+    std::sort(entries.begin(), entries.end(), [&](EntryId a, EntryId b) {
+        if (volumes[a] != volumes[b]) return volumes[a] < volumes[b];
+        return offsets[a] != offsets[b] ? offsets[a] < offsets[b] : a < b;
+    });
+}
+
+} // namespace unpaker
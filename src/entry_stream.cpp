@@ -0,0 +1,103 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "entry_stream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace unpaker {
+
+EntrySegment EntrySegment::from_file(std::shared_ptr<const RandomAccessFile> file, uint64_t offset, uint64_t length) {
+    EntrySegment segment;
+    segment.file = std::move(file);
+    segment.offset = offset;
+    segment.length = length;
+    return segment;
+}
+
+EntrySegment EntrySegment::from_memory(std::shared_ptr<const void> owner, const uint8_t* data, uint64_t length) {
+    EntrySegment segment;
+    segment.memory_owner = std::move(owner);
+    segment.memory = data;
+    segment.length = length;
+    return segment;
+}
+
+EntryStream::EntryStream(std::vector<EntrySegment> segments) : open_(true) {
+    for (auto& segment : segments) {
+        if (segment.length == 0) continue;
+        starts_.push_back(size_);
+        size_ += segment.length;
+        segments_.push_back(std::move(segment));
+    }
+}
+
+bool EntryStream::seek(uint64_t position) {
+    if (!open_ || position > size_) {
+        return false;
+    }
+
+    position_ = position;
+    failed_ = false;
+    auto it = std::upper_bound(starts_.begin(), starts_.end(), position);
+    segment_ = it == starts_.begin() ? 0 : static_cast<size_t>(it - starts_.begin()) - 1;
+    return true;
+}
+
+size_t EntryStream::read(void* buffer, size_t length) {
+    if (!open_ || failed_) {
+        return 0;
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    size_t total = 0;
+
+    while (total < length && position_ < size_) {
+        while (position_ >= starts_[segment_] + segments_[segment_].length) {
+            ++segment_;
+        }
+
+        const EntrySegment& segment = segments_[segment_];
+        uint64_t within = position_ - starts_[segment_];
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - total, segment.length - within));
+
+        size_t got;
+        if (segment.memory) {
+            std::memcpy(out + total, segment.memory + within, chunk);
+            got = chunk;
+        } else {
+            got = segment.file ? segment.file->read_at(segment.offset + within, out + total, chunk) : 0;
+        }
+
+        total += got;
+        position_ += got;
+        if (got < chunk) {
+            failed_ = true;
+            break;
+        }
+    }
+
+    return total;
+}
+
+bool EntryStream::copy_to(const ChunkCallback& on_chunk, size_t chunk_size) {
+    if (!open_ || chunk_size == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(std::min<uint64_t>(chunk_size, size_ - std::min(position_, size_))));
+    while (!eof()) {
+        size_t got = read(buffer.data(), buffer.size());
+        if (got > 0 && !on_chunk(buffer.data(), got)) {
+            return false;
+        }
+        if (failed_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace unpaker
@@ -0,0 +1,71 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "file_handle_pool.hpp"
+#include "logger.hpp"
+#include <cstdint>
+
+namespace unpaker {
+
+FileHandlePool::FileHandlePool(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {
+}
+
+void FileHandlePool::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity > 0 ? capacity : SIZE_MAX;
+    while (lru_.size() > capacity_) {
+        handles_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+std::shared_ptr<const RandomAccessFile> FileHandlePool::acquire(const fs::path& path) {
+    std::string key = path.string();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = handles_.find(key);
+        if (it != handles_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Open outside the lock so a slow open does not stall readers of other volumes
+    auto handle = std::make_shared<RandomAccessFile>();
+    if (!handle->open(path)) {
+        DEBUG_CERR("[DEBUG] FileHandlePool: Could not open " << key << std::endl);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handles_.find(key);
+    if (it != handles_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+
+    lru_.emplace_front(key, handle);
+    handles_[key] = lru_.begin();
+
+    while (lru_.size() > capacity_) {
+        handles_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+
+    return handle;
+}
+
+void FileHandlePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handles_.clear();
+    lru_.clear();
+}
+
+size_t FileHandlePool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+} // namespace unpaker
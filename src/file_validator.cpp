@@ -4,8 +4,12 @@
 
 #include "file_validator.hpp"
 #include "logger.hpp"
+#include "crc32.hpp"
+#include "thread_pool.hpp"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 namespace unpaker {
 
@@ -68,6 +72,75 @@ ValidationResult FileValidator::validateArchive(const std::shared_ptr<DirectoryE
     return result;
 }
 
+ValidationResult FileValidator::validateArchive(const ArchiveIndex& index, uint64_t) {
+    ValidationResult result;
+    result.total_files = static_cast<uint32_t>(index.entry_count());
+
+    Logger::instance().info(std::string("Validating archive with ") + std::to_string(result.total_files) + " files...");
+
+    // Entries of one directory are contiguous, so duplicates only need a per-directory sort
+    std::vector<std::string_view> names;
+    for (DirId dir = 0; dir < index.directory_count(); ++dir) {
+        EntryId first = index.first_file(dir);
+        uint32_t count = index.file_count(dir);
+        if (count == 0) continue;
+
+        std::string dir_path = index.directory_path(dir);
+        auto full_path = [&dir_path](std::string_view name) {
+            return dir_path.empty() ? std::string(name) : dir_path + '/' + std::string(name);
+        };
+
+        names.clear();
+        for (EntryId id = first; id < first + count; ++id) {
+            names.push_back(index.name(id));
+        }
+        std::sort(names.begin(), names.end());
+        for (size_t i = 1; i < names.size(); ++i) {
+            if (names[i] == names[i - 1]) {
+                result.duplicate_files++;
+                result.warnings.push_back("  Duplicate: " + full_path(names[i]));
+            }
+        }
+
+        for (EntryId id = first; id < first + count; ++id) {
+            std::string path = full_path(index.name(id));
+            if (!validatePath(path)) {
+                result.invalid_entries++;
+                result.is_valid = false;
+                result.error_messages.push_back("Invalid entry: " + path);
+            }
+
+            if (index.size(id) == 0) {
+                result.zero_size_files++;
+                result.warnings.push_back("Zero-size file: " + path);
+            }
+        }
+    }
+
+    if (result.duplicate_files > 0) {
+        result.warnings.insert(result.warnings.begin(),
+                               "Found " + std::to_string(result.duplicate_files) + " duplicate file entries");
+    }
+
+    if (result.error_messages.empty()) {
+        Logger::instance().success("Archive validation passed");
+    } else {
+        Logger::instance().warning(std::string("Archive validation found ") + std::to_string(result.error_messages.size()) + " errors:");
+        for (const auto& error : result.error_messages) {
+            Logger::instance().error(error);
+        }
+    }
+
+    if (!result.warnings.empty()) {
+        Logger::instance().info(std::string("Found ") + std::to_string(result.warnings.size()) + " warnings:");
+        for (const auto& warning : result.warnings) {
+            Logger::instance().warning(warning);
+        }
+    }
+
+    return result;
+}
+
 uint32_t FileValidator::checkDuplicates(const std::vector<std::shared_ptr<FileEntry>>& files,
                                                                                std::vector<std::string>& duplicates) {
     std::set<std::string> seen;
@@ -87,26 +160,227 @@ uint32_t FileValidator::checkDuplicates(const std::vector<std::shared_ptr<FileEn
     return dup_count;
 }
 
+namespace {
+
+// Work unit for the checksum scan: a run of entries from one volume in offset order, so each
+// thread sweeps its own region of the disk sequentially
+constexpr uint64_t VERIFY_CHUNK_BYTES = 32 * 1024 * 1024;
+constexpr size_t VERIFY_CHUNK_ENTRIES = 4096;
+// Larger entries get a chunk of their own and are hashed through a stream, so memory use does
+// not grow with entry size
+constexpr uint64_t STREAMED_ENTRY_SIZE = 16 * 1024 * 1024;
+
+struct VerifyChunk {
+    size_t begin;
+    size_t end;
+    bool streamed = false;
+};
+
+struct VerifyChunkResult {
+    uint32_t verified = 0;
+    uint64_t bytes = 0;
+    std::vector<ChecksumMismatch> mismatches;
+    std::vector<std::string> unreadable;
+};
+
+} // namespace
+
+IntegrityReport FileValidator::verifyChecksums(const PakParser& parser, uint32_t thread_count) {
+    IntegrityReport report;
+    auto start_time = std::chrono::steady_clock::now();
+
+    if (!parser.has_entry_checksums()) {
+        report.supported = false;
+        Logger::instance().warning("Checksum verification is not supported for " + parser.get_format_info());
+        return report;
+    }
+
+    const ArchiveIndex& index = parser.get_index();
+    const auto& volumes = index.archive_index_column();
+    const auto& offsets = index.offset_column();
+    const auto& sizes = index.size_column();
+
+    std::vector<EntryId> files(index.entry_count());
+    for (EntryId id = 0; id < files.size(); ++id) {
+        files[id] = id;
+    }
+    report.total_files = static_cast<uint32_t>(files.size());
+
+    std::stable_sort(files.begin(), files.end(), [&](EntryId a, EntryId b) {
+        return volumes[a] != volumes[b] ? volumes[a] < volumes[b] : offsets[a] < offsets[b];
+    });
+
+    std::vector<VerifyChunk> chunks;
+    size_t chunk_begin = 0;
+    uint64_t chunk_bytes = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        bool streamed = sizes[files[i]] > STREAMED_ENTRY_SIZE;
+        bool new_volume = i > chunk_begin && volumes[files[i]] != volumes[files[chunk_begin]];
+        if (i > chunk_begin && (streamed || new_volume || chunk_bytes >= VERIFY_CHUNK_BYTES ||
+                                i - chunk_begin >= VERIFY_CHUNK_ENTRIES)) {
+            chunks.push_back({chunk_begin, i});
+            chunk_begin = i;
+            chunk_bytes = 0;
+        }
+        if (streamed) {
+            chunks.push_back({i, i + 1, true});
+            chunk_begin = i + 1;
+            continue;
+        }
+        chunk_bytes += sizes[files[i]];
+    }
+    if (chunk_begin < files.size()) {
+        chunks.push_back({chunk_begin, files.size()});
+    }
+
+    Logger::instance().info("Verifying " + std::to_string(files.size()) + " files in " +
+                            std::to_string(chunks.size()) + " chunks (" + crc32_implementation() + ")");
+
+    std::vector<VerifyChunkResult> results(chunks.size());
+    // Chunks already spread over the threads, so each one reads its batch on its own thread
+    size_t workers = std::min(ThreadPool::resolve_thread_count(thread_count), chunks.size());
+    uint32_t read_threads = workers > 1 ? 1 : 0;
+
+    auto verify_chunk = [&](size_t c) {
+        VerifyChunkResult& result = results[c];
+        if (chunks[c].streamed) {
+            auto file = index.make_file_entry(files[chunks[c].begin]);
+            EntryStream stream = parser.open_file(file);
+            uint32_t actual = 0;
+            bool complete = stream.is_open() && stream.size() == file->size &&
+                            stream.copy_to([&actual](const uint8_t* data, size_t length) {
+                                actual = crc32(data, length, actual);
+                                return true;
+                            });
+            if (!complete) {
+                result.unreadable.push_back(file->path);
+                return;
+            }
+            result.bytes += file->size;
+            if (actual != file->crc) {
+                result.mismatches.push_back({file->path, file->crc, actual});
+            } else {
+                result.verified++;
+            }
+            return;
+        }
+
+        std::vector<std::shared_ptr<FileEntry>> batch;
+        batch.reserve(chunks[c].end - chunks[c].begin);
+        for (size_t i = chunks[c].begin; i < chunks[c].end; ++i) {
+            batch.push_back(index.make_file_entry(files[i]));
+        }
+        parser.extract_files(batch, [&result](const std::shared_ptr<FileEntry>& file,
+                                              bool success,
+                                              std::vector<uint8_t>& data) {
+            if (!success || data.size() != file->size) {
+                result.unreadable.push_back(file->path);
+                return;
+            }
+            uint32_t actual = crc32(data.data(), data.size());
+            result.bytes += data.size();
+            if (actual != file->crc) {
+                result.mismatches.push_back({file->path, file->crc, actual});
+            } else {
+                result.verified++;
+            }
+        }, read_threads);
+    };
+
+    ThreadPool::run(chunks.size(), workers, verify_chunk);
+
+    for (auto& result : results) {
+        report.verified_files += result.verified;
+        report.bytes_verified += result.bytes;
+        report.mismatches.insert(report.mismatches.end(), result.mismatches.begin(), result.mismatches.end());
+        report.unreadable_files.insert(report.unreadable_files.end(), result.unreadable.begin(), result.unreadable.end());
+    }
+
+    std::sort(report.mismatches.begin(), report.mismatches.end(),
+              [](const ChecksumMismatch& a, const ChecksumMismatch& b) { return a.path < b.path; });
+    std::sort(report.unreadable_files.begin(), report.unreadable_files.end());
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    char summary[256];
+    snprintf(summary, sizeof(summary), "Verified %u/%u files, %.1f MB in %.2f s (%.2f GB/s)",
+             report.verified_files, report.total_files, report.bytes_verified / (1024.0 * 1024.0),
+             report.seconds, report.throughput_gbps());
+
+    if (report.passed()) {
+        Logger::instance().success(summary);
+    } else {
+        Logger::instance().warning(summary);
+        for (const auto& mismatch : report.mismatches) {
+            char line[64];
+            snprintf(line, sizeof(line), " (expected %08x, got %08x)", mismatch.expected, mismatch.actual);
+            Logger::instance().error("CRC mismatch: " + mismatch.path + line);
+        }
+        for (const auto& path : report.unreadable_files) {
+            Logger::instance().error("Unreadable: " + path);
+        }
+    }
+
+    return report;
+}
+
+ValidationResult FileValidator::verifySectionChecksums(const PakParser& parser) {
+    ValidationResult result;
+    result.total_files = parser.get_file_count();
+
+    SectionChecksumReport report = parser.verify_section_checksums();
+    result.section_checksums_present = report.present;
+    result.section_chunks_checked = report.chunks_checked;
+    result.section_chunks_failed = report.chunks_failed;
+
+    if (!report.present) {
+        result.warnings.push_back("Archive has no checksum sections");
+        Logger::instance().info("Archive has no checksum sections to verify");
+        return result;
+    }
+
+    for (const auto& failure : report.failures) {
+        result.is_valid = false;
+        result.error_messages.push_back(failure);
+        Logger::instance().error(failure);
+    }
+
+    std::string summary = "Checked " + std::to_string(report.chunks_checked) + " checksum sections (" +
+                          std::to_string(report.bytes_hashed / (1024 * 1024)) + " MB hashed), " +
+                          std::to_string(report.chunks_failed) + " failed";
+    if (result.is_valid) {
+        Logger::instance().success(summary);
+    } else {
+        Logger::instance().warning(summary);
+    }
+
+    return result;
+}
+
 bool FileValidator::validateFileEntry(const std::shared_ptr<FileEntry>& entry,
                                                                          uint64_t) {
     if (!entry) return false;
 
-    if (entry->path.empty()) {
+    return validatePath(entry->path);
+}
+
+bool FileValidator::validatePath(const std::string& path) {
+    if (path.empty()) {
         std::cerr << "[WARNING] File entry has empty path" << std::endl;
         return false;
     }
 
-    if (entry->path.length() > 1024) {
-        std::cerr << "[WARNING] File path exceeds 1024 characters: " << entry->path.length() << std::endl;
+    if (path.length() > 1024) {
+        std::cerr << "[WARNING] File path exceeds 1024 characters: " << path.length() << std::endl;
         return false;
     }
 
-    for (size_t i = 0; i < entry->path.length(); ++i) {
-        unsigned char c = entry->path[i];
+    for (size_t i = 0; i < path.length(); ++i) {
+        unsigned char c = path[i];
         if (c < 32 || c > 126) {
             if (c != '/' && c != '\\') {
                 std::cerr << "[WARNING] File path contains invalid character (0x" << std::hex
-                                                  << (int)c << std::dec << ") in: " << entry->path << std::endl;
+                                                  << (int)c << std::dec << ") in: " << path << std::endl;
                 return false;
             }
         }
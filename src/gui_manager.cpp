@@ -10,6 +10,7 @@
 #include "file_validator.hpp"
 #include "config.hpp"
 #include "logger.hpp"
+#include "text_assets.hpp"
 
 using unpaker::Logger;
 #include <commctrl.h>
@@ -33,6 +34,28 @@ namespace unpaker {
 
 static GuiManager* g_gui_instance = nullptr;
 
+// Tree items carry EntryId + 1 for files and -(DirId + 1) for directories
+static LPARAM file_item_param(EntryId id) {
+    return static_cast<LPARAM>(id) + 1;
+}
+
+static LPARAM directory_item_param(DirId id) {
+    return -static_cast<LPARAM>(id) - 1;
+}
+
+// Index names are not null-terminated, so convert with an explicit length
+static wchar_t* to_wide_name(std::string_view text) {
+    static std::vector<wchar_t> wide_buffer(MAX_PATH * 2);
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), NULL, 0);
+    if (length + 1 > (int)wide_buffer.size()) {
+        wide_buffer.resize((length + 1) * 2);
+    }
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide_buffer.data(), length);
+    wide_buffer[length] = L'\0';
+    return wide_buffer.data();
+}
+
 LRESULT CALLBACK GuiManager::window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
     if (msg == WM_CREATE) {
         CREATESTRUCT* pCreate = reinterpret_cast<CREATESTRUCT*>(lparam);
@@ -158,6 +181,7 @@ void GuiManager::create_controls() {
     HMENU file_menu = CreateMenu();
 
     AppendMenu(file_menu, MF_STRING, 1001, L"Open Archive\tCtrl+O");
+    AppendMenu(file_menu, MF_STRING, 1006, L"Verify Integrity");
     AppendMenu(file_menu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(file_menu, MF_STRING, 1002, L"Exit\tCtrl+Q");
     AppendMenu(menu_bar, MF_POPUP, (UINT_PTR)file_menu, L"File");
@@ -296,6 +320,8 @@ LRESULT GuiManager::handle_message(UINT msg, WPARAM wparam, LPARAM lparam) {
                 handle_open_file();
             } else if (cmd_id == 1005) { // Check for updates
                 check_for_updates();
+            } else if (cmd_id == 1006) { // Verify Integrity
+                handle_verify_integrity();
             }
             return 0;
         }
@@ -306,29 +332,20 @@ LRESULT GuiManager::handle_message(UINT msg, WPARAM wparam, LPARAM lparam) {
                 LPNMTREEVIEW pnmtv = reinterpret_cast<LPNMTREEVIEW>(lparam);
                 TVITEMW item = pnmtv->itemNew;
 
-                if (item.hItem != NULL) {
-                    wchar_t item_text[MAX_PATH] = {0};
-                    TVITEMW tvitem = {};
-                    tvitem.hItem = item.hItem;
-                    tvitem.mask = TVIF_TEXT;
-                    tvitem.pszText = item_text;
-                    tvitem.cchTextMax = MAX_PATH;
-                    TreeView_GetItem(tree_view, &tvitem);
-
-                    int size_needed = WideCharToMultiByte(CP_UTF8, 0, item_text, -1, NULL, 0, NULL, NULL);
-                    std::string selected_name(size_needed, 0);
-                    WideCharToMultiByte(CP_UTF8, 0, item_text, -1, &selected_name[0], size_needed, NULL, NULL);
-                    selected_name.pop_back();
-
-                    auto root = parser->get_root();
-                    if (root) {
-                        std::shared_ptr<FileEntry> found_file = find_file_in_tree(root, selected_name);
-                        if (found_file) {
-                            preview_file(found_file);
-                        }
+                if (item.hItem != NULL && item.lParam > 0) {
+                    const ArchiveIndex& index = parser->get_index();
+                    EntryId id = static_cast<EntryId>(item.lParam - 1);
+                    if (id < index.entry_count()) {
+                        preview_file(index.make_file_entry(id));
                     }
-                    selected_name.clear();
-                    selected_name.shrink_to_fit();
+                }
+            } else if (hdr->hwndFrom == tree_view && hdr->code == TVN_ITEMEXPANDING) {
+                // Directories are filled in the first time they are opened
+                LPNMTREEVIEW pnmtv = reinterpret_cast<LPNMTREEVIEW>(lparam);
+                const TVITEMW& item = pnmtv->itemNew;
+                if ((pnmtv->action & TVE_EXPAND) && item.lParam < 0 &&
+                    TreeView_GetChild(tree_view, item.hItem) == NULL) {
+                    populate_directory_item(item.hItem, static_cast<DirId>(-item.lParam - 1));
                 }
             } else if (hdr->hwndFrom == tree_view && hdr->code == TVN_ITEMEXPANDED) {
                 InvalidateRect(tree_view, nullptr, FALSE);
@@ -448,10 +465,9 @@ void GuiManager::load_archive(const fs::path& pak_path) {
         populate_tree_view();
         display_archive_info();
 
-        auto root = parser->get_root();
         fs::path archive_path(loaded_archive_path);
         uint64_t archive_size = fs::file_size(archive_path);
-        auto validation = FileValidator::validateArchive(root, archive_size);
+        auto validation = FileValidator::validateArchive(parser->get_index(), archive_size);
 
         if (!validation.is_valid) {
             std::cerr << "[WARNING] Archive validation failed with " << validation.invalid_entries
@@ -477,78 +493,86 @@ void GuiManager::load_archive(const fs::path& pak_path) {
     is_loading = false;
 }
 
-void GuiManager::populate_tree_view() {
-    if (!tree_view || !parser) return;
+void GuiManager::handle_verify_integrity() {
+    if (!parser || is_loading) {
+        MessageBoxW(main_window, L"Open an archive first.", L"Verify Integrity", MB_OK | MB_ICONINFORMATION);
+        return;
+    }
 
-    SendMessage(tree_view, WM_SETREDRAW, FALSE, 0);
+    set_status_text("Verifying archive...");
+    HCURSOR previous_cursor = SetCursor(LoadCursor(nullptr, IDC_WAIT));
 
-    TreeView_DeleteAllItems(tree_view);
-
-    auto root = parser->get_root();
-    if (!root) {
-        SendMessage(tree_view, WM_SETREDRAW, TRUE, 0);
+    IntegrityReport report;
+    ValidationResult sections;
+    try {
+        sections = FileValidator::verifySectionChecksums(*parser);
+        report = FileValidator::verifyChecksums(*parser);
+    } catch (const std::exception& e) {
+        SetCursor(previous_cursor);
+        std::cerr << "[ERROR] Exception while verifying archive: " << e.what() << std::endl;
+        MessageBoxA(main_window, e.what(), "Error", MB_OK | MB_ICONERROR);
+        set_status_text("Verification failed");
         return;
     }
 
-    try {
-        TVINSERTSTRUCT tvinsert = {};
-        tvinsert.hParent = TVI_ROOT;
-        tvinsert.hInsertAfter = TVI_LAST;
-        tvinsert.item.mask = TVIF_TEXT;
+    SetCursor(previous_cursor);
 
-        static std::vector<wchar_t> wide_buffer(MAX_PATH * 2);
+    if (!report.supported && !sections.section_checksums_present) {
+        MessageBoxW(main_window, L"This archive format does not store checksums.",
+                    L"Verify Integrity", MB_OK | MB_ICONINFORMATION);
+        set_status_text("Ready");
+        return;
+    }
 
-        const char* root_name = root->name.empty() ? "Archive" : root->name.c_str();
-        int root_len = MultiByteToWideChar(CP_UTF8, 0, root_name, -1, NULL, 0);
-        if (root_len > (int)wide_buffer.size()) {
-            wide_buffer.resize(root_len * 2);
-        }
-        MultiByteToWideChar(CP_UTF8, 0, root_name, -1, wide_buffer.data(), root_len);
+    bool passed = (!report.supported || report.passed()) && sections.is_valid;
 
-        tvinsert.item.pszText = wide_buffer.data();
-        HTREEITEM root_item = TreeView_InsertItem(tree_view, &tvinsert);
+    wchar_t crc_summary[256] = L"Per-file CRC-32: not stored by this format";
+    if (report.supported) {
+        swprintf_s(crc_summary, sizeof(crc_summary) / sizeof(wchar_t),
+                   L"Verified %u of %u files (%.1f MB) in %.2f s, %.2f GB/s\nCRC mismatches: %zu\nUnreadable files: %zu",
+                   report.verified_files, report.total_files, report.bytes_verified / (1024.0 * 1024.0),
+                   report.seconds, report.throughput_gbps(), report.mismatches.size(), report.unreadable_files.size());
+    }
 
-        DEBUG_COUT("[DEBUG] TreeView: Created root item: " << root_name << std::endl);
-        DEBUG_COUT("[DEBUG] TreeView: Subdirectories count: " << root->subdirectories.size() << std::endl);
+    wchar_t section_summary[128] = L"MD5 sections: not present";
+    if (sections.section_checksums_present) {
+        swprintf_s(section_summary, sizeof(section_summary) / sizeof(wchar_t),
+                   L"MD5 sections: %u checked, %u failed",
+                   sections.section_chunks_checked, sections.section_chunks_failed);
+    }
 
-        std::function<void(const std::shared_ptr<DirectoryEntry>&, HTREEITEM)> add_items =
-            [&](const std::shared_ptr<DirectoryEntry>& dir, HTREEITEM parent_item) {
-                if (!dir) return;
+    wchar_t summary[512];
+    swprintf_s(summary, sizeof(summary) / sizeof(wchar_t), L"%s\n\n%s%s",
+               crc_summary, section_summary, passed ? L"" : L"\n\nSee the log for details.");
+    MessageBoxW(main_window, summary, L"Verify Integrity",
+                MB_OK | (passed ? MB_ICONINFORMATION : MB_ICONWARNING));
 
-                for (const auto& file : dir->files) {
-                    if (!file) continue;
+    set_status_text(passed ? "Verification passed" : "Verification found errors");
+}
 
-                    const char* file_name = file->name.c_str();
-                    int file_len = MultiByteToWideChar(CP_UTF8, 0, file_name, -1, NULL, 0);
-                    if (file_len > (int)wide_buffer.size()) {
-                        wide_buffer.resize(file_len * 2);
-                    }
-                    MultiByteToWideChar(CP_UTF8, 0, file_name, -1, wide_buffer.data(), file_len);
+void GuiManager::populate_tree_view() {
+    if (!tree_view || !parser) return;
 
-                    tvinsert.hParent = parent_item;
-                    tvinsert.item.pszText = wide_buffer.data();
-                    TreeView_InsertItem(tree_view, &tvinsert);
-                }
+    SendMessage(tree_view, WM_SETREDRAW, FALSE, 0);
 
-                for (const auto& subdir : dir->subdirectories) {
-                    if (!subdir) continue;
+    TreeView_DeleteAllItems(tree_view);
 
-                    const char* dir_name = subdir->name.c_str();
-                    int dir_len = MultiByteToWideChar(CP_UTF8, 0, dir_name, -1, NULL, 0);
-                    if (dir_len > (int)wide_buffer.size()) {
-                        wide_buffer.resize(dir_len * 2);
-                    }
-                    MultiByteToWideChar(CP_UTF8, 0, dir_name, -1, wide_buffer.data(), dir_len);
+    try {
+        TVINSERTSTRUCT tvinsert = {};
+        tvinsert.hParent = TVI_ROOT;
+        tvinsert.hInsertAfter = TVI_LAST;
+        tvinsert.item.mask = TVIF_TEXT | TVIF_PARAM;
 
-                    tvinsert.hParent = parent_item;
-                    tvinsert.item.pszText = wide_buffer.data();
-                    HTREEITEM new_item = TreeView_InsertItem(tree_view, &tvinsert);
+        std::string root_name = fs::path(loaded_archive_path).filename().string();
+        tvinsert.item.pszText = to_wide_name(root_name.empty() ? std::string_view("Archive") : std::string_view(root_name));
+        tvinsert.item.lParam = directory_item_param(ROOT_DIR_ID);
+        HTREEITEM root_item = TreeView_InsertItem(tree_view, &tvinsert);
 
-                    add_items(subdir, new_item);
-                }
-            };
+        DEBUG_COUT("[DEBUG] TreeView: Created root item: " << root_name << std::endl);
+        DEBUG_COUT("[DEBUG] TreeView: Subdirectories count: "
+                   << parser->get_index().subdirectory_count(ROOT_DIR_ID) << std::endl);
 
-        add_items(root, root_item);
+        populate_directory_item(root_item, ROOT_DIR_ID);
 
         TreeView_Expand(tree_view, root_item, TVE_EXPAND);
 
@@ -562,6 +586,33 @@ void GuiManager::populate_tree_view() {
     RedrawWindow(tree_view, nullptr, nullptr, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN);
 }
 
+void GuiManager::populate_directory_item(HTREEITEM item, DirId dir) {
+    const ArchiveIndex& index = parser->get_index();
+    if (dir >= index.directory_count()) return;
+
+    TVINSERTSTRUCT tvinsert = {};
+    tvinsert.hParent = item;
+    tvinsert.hInsertAfter = TVI_LAST;
+    tvinsert.item.mask = TVIF_TEXT | TVIF_PARAM;
+
+    EntryId first_file = index.first_file(dir);
+    for (EntryId id = first_file; id < first_file + index.file_count(dir); ++id) {
+        tvinsert.item.pszText = to_wide_name(index.name(id));
+        tvinsert.item.lParam = file_item_param(id);
+        TreeView_InsertItem(tree_view, &tvinsert);
+    }
+
+    // Subdirectories only get an expand button here; their own items are added on first expansion
+    tvinsert.item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN;
+    DirId first_subdir = index.first_subdirectory(dir);
+    for (DirId subdir = first_subdir; subdir < first_subdir + index.subdirectory_count(dir); ++subdir) {
+        tvinsert.item.pszText = to_wide_name(index.directory_name(subdir));
+        tvinsert.item.lParam = directory_item_param(subdir);
+        tvinsert.item.cChildren = (index.file_count(subdir) + index.subdirectory_count(subdir)) > 0 ? 1 : 0;
+        TreeView_InsertItem(tree_view, &tvinsert);
+    }
+}
+
 void GuiManager::display_archive_info() {
     if (!info_text) return;
     SetWindowTextW(info_text, L"");
@@ -577,26 +628,8 @@ void GuiManager::preview_file(const std::shared_ptr<FileEntry>& file) {
     }
 
     const char* ext_ptr = file->name.c_str() + dot_pos + 1;
-    
-    static constexpr const char* supported_exts[] = {"txt", "cfg", "ini", "md", "log", "conf", "config", "properties", "xml", "json"};
-    bool is_supported = false;
-    
-    for (const char* supported : supported_exts) {
-        const char* ext_check = ext_ptr;
-        const char* sup_check = supported;
-        while (*ext_check && *sup_check) {
-            char ext_lower = static_cast<char>(std::tolower(static_cast<unsigned char>(*ext_check)));
-            if (ext_lower != *sup_check) break;
-            ++ext_check;
-            ++sup_check;
-        }
-        if (*ext_check == '\0' && *sup_check == '\0') {
-            is_supported = true;
-            break;
-        }
-    }
 
-    if (!is_supported) {
+    if (!unpaker::is_text_asset(file->name)) {
         static wchar_t msg_buffer[512];
         int len = swprintf_s(msg_buffer, sizeof(msg_buffer) / sizeof(wchar_t), L"[Unsupported format: .%hs]\n Supported: .txt, .cfg, .ini, .md, .log, .conf, .config, .properties, .xml, .json", ext_ptr);
         if (len > 0) {
@@ -843,23 +876,6 @@ bool GuiManager::should_close() const {
     return !is_running;
 }
 
-std::shared_ptr<FileEntry> GuiManager::find_file_in_tree(const std::shared_ptr<DirectoryEntry>& dir, const std::string& filename) {
-    if (!dir) return nullptr;
-
-    for (const auto& file : dir->files) {
-        if (file && file->name == filename) {
-            return file;
-        }
-    }
-
-    for (const auto& subdir : dir->subdirectories) {
-        auto result = find_file_in_tree(subdir, filename);
-        if (result) return result;
-    }
-
-    return nullptr;
-}
-
 void GuiManager::check_for_updates() {
     if (!main_window) return;
 
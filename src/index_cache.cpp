@@ -0,0 +1,311 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "index_cache.hpp"
+#include "mapped_file.hpp"
+#include "logger.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace unpaker {
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x494B5055; // "UPKI"
+constexpr uint32_t CACHE_VERSION = 6;
+
+struct ArchiveKey {
+    std::string path;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+std::string normalized_key_path(const fs::path& archive_path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(archive_path, ec);
+    return (ec ? archive_path : absolute).lexically_normal().generic_string();
+}
+
+bool make_archive_key(const fs::path& archive_path, ArchiveKey& key) {
+    std::error_code ec;
+    key.path = normalized_key_path(archive_path);
+
+    key.size = fs::file_size(archive_path, ec);
+    if (ec) return false;
+
+    auto mtime = fs::last_write_time(archive_path, ec);
+    if (ec) return false;
+    key.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    return true;
+}
+
+uint64_t fnv1a64(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+class CacheWriter {
+public:
+    explicit CacheWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    template <typename T>
+    void put(T value) {
+        size_t pos = out.size();
+        out.resize(pos + sizeof(T));
+        std::memcpy(out.data() + pos, &value, sizeof(T));
+    }
+
+    void put_string(const std::string& text) {
+        put(static_cast<uint32_t>(text.size()));
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    void put_bytes(const std::vector<uint8_t>& bytes) {
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+class CacheReader {
+public:
+    CacheReader(const uint8_t* data, uint64_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (pos + sizeof(T) > size) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& text) {
+        uint32_t length = 0;
+        if (!get(length) || pos + length > size) return false;
+        text.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+
+    const uint8_t* remaining(uint64_t& length) const {
+        length = size - pos;
+        return data + pos;
+    }
+
+    bool at_end() const {
+        return pos == size;
+    }
+
+private:
+    const uint8_t* data;
+    uint64_t size;
+    uint64_t pos = 0;
+};
+
+} // namespace
+
+IndexCache::IndexCache() : cache_dir(default_cache_dir()) {
+}
+
+IndexCache::IndexCache(const fs::path& cache_dir) : cache_dir(cache_dir) {
+}
+
+fs::path IndexCache::default_cache_dir() {
+    std::error_code ec;
+    fs::path temp_dir = fs::temp_directory_path(ec);
+    if (ec) {
+        return fs::path();
+    }
+    return temp_dir / "unPAKer" / "index_cache";
+}
+
+const fs::path& IndexCache::get_cache_dir() const {
+    return cache_dir;
+}
+
+fs::path IndexCache::get_cache_file(const fs::path& archive_path) const {
+    if (cache_dir.empty()) {
+        return fs::path();
+    }
+
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << fnv1a64(normalized_key_path(archive_path)) << ".idx";
+    return cache_dir / name.str();
+}
+
+bool IndexCache::load(const fs::path& archive_path,
+                      ArchiveIndex& index,
+                      uint32_t& file_count,
+                      uint32_t& format) const {
+    fs::path cache_file = get_cache_file(archive_path);
+    std::error_code ec;
+    if (cache_file.empty() || !fs::exists(cache_file, ec)) {
+        return false;
+    }
+
+    ArchiveKey key;
+    if (!make_archive_key(archive_path, key)) {
+        return false;
+    }
+
+    MappedFile mapping;
+    if (!mapping.open(cache_file) || !mapping.data()) {
+        return false;
+    }
+
+    CacheReader reader(mapping.data(), mapping.size());
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t cached_format = 0;
+    uint32_t cached_file_count = 0;
+    uint64_t cached_size = 0;
+    int64_t cached_mtime = 0;
+    std::string cached_path;
+
+    if (!reader.get(magic) || !reader.get(version) || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        LOG_DEBUG("IndexCache: Ignoring cache file with unknown layout: " + cache_file.string());
+        return false;
+    }
+
+    if (!reader.get(cached_format) || !reader.get(cached_file_count) ||
+        !reader.get(cached_size) || !reader.get(cached_mtime) || !reader.get_string(cached_path)) {
+        return false;
+    }
+
+    if (cached_path != key.path || cached_size != key.size || cached_mtime != key.mtime) {
+        LOG_DEBUG("IndexCache: Stale cache entry for " + key.path);
+        return false;
+    }
+
+    // The index is stored as raw columns and validated as a whole on load
+    uint64_t index_size = 0;
+    const uint8_t* index_data = reader.remaining(index_size);
+    ArchiveIndex loaded;
+    if (!loaded.deserialize(index_data, static_cast<size_t>(index_size)) ||
+        loaded.entry_count() != cached_file_count) {
+        std::cerr << "[WARNING] IndexCache: Corrupt cache file, ignoring: " << cache_file.string() << std::endl;
+        return false;
+    }
+
+    index = std::move(loaded);
+    file_count = cached_file_count;
+    format = cached_format;
+    return true;
+}
+
+bool IndexCache::store(const fs::path& archive_path,
+                       const ArchiveIndex& index,
+                       uint32_t file_count,
+                       uint32_t format) const {
+    fs::path cache_file = get_cache_file(archive_path);
+    if (cache_file.empty()) return false;
+
+    ArchiveKey key;
+    if (!make_archive_key(archive_path, key)) {
+        return false;
+    }
+
+    std::vector<uint8_t> columns;
+    index.serialize(columns);
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(64 + key.path.size() + columns.size());
+
+    CacheWriter writer(buffer);
+    writer.put(CACHE_MAGIC);
+    writer.put(CACHE_VERSION);
+    writer.put(format);
+    writer.put(file_count);
+    writer.put(key.size);
+    writer.put(key.mtime);
+    writer.put_string(key.path);
+    writer.put_bytes(columns);
+
+    try {
+        fs::create_directories(cache_dir);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "[WARNING] IndexCache: Failed to store cache: " << e.what() << std::endl;
+        return false;
+    }
+
+    fs::path temp_file = temp_file_for(cache_file);
+    bool written = false;
+    {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[WARNING] IndexCache: Failed to open cache file for writing: "
+                                              << temp_file.string() << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        written = out.good();
+    }
+
+    std::error_code ec;
+    if (!written) {
+        std::cerr << "[WARNING] IndexCache: Failed to write cache file: " << temp_file.string() << std::endl;
+    } else {
+        fs::rename(temp_file, cache_file, ec);
+        if (ec) {
+            std::cerr << "[WARNING] IndexCache: Failed to store cache: " << ec.message() << std::endl;
+        }
+    }
+    if (!written || ec) {
+        std::error_code remove_ec;
+        fs::remove(temp_file, remove_ec);
+        return false;
+    }
+
+    DEBUG_COUT("[DEBUG] IndexCache: Stored " << file_count << " entries (" << buffer.size()
+                                             << " bytes) in " << cache_file.string() << std::endl);
+    return true;
+}
+
+fs::path IndexCache::temp_file_for(const fs::path& target) {
+#ifdef _WIN32
+    unsigned long process_id = static_cast<unsigned long>(_getpid());
+#else
+    unsigned long process_id = static_cast<unsigned long>(getpid());
+#endif
+    std::random_device device;
+    uint64_t suffix = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                      std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    std::ostringstream name;
+    name << "." << process_id << "." << std::hex << std::setw(16) << std::setfill('0') << suffix << ".tmp";
+    fs::path temp_file = target;
+    temp_file += name.str();
+    return temp_file;
+}
+
+bool IndexCache::invalidate(const fs::path& archive_path) const {
+    fs::path cache_file = get_cache_file(archive_path);
+    if (cache_file.empty()) return false;
+
+    std::error_code ec;
+    return fs::remove(cache_file, ec);
+}
+
+} // namespace unpaker
@@ -0,0 +1,57 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "lazy_directory_tree.hpp"
+#include "pak_parser.hpp"
+
+namespace unpaker {
+
+LazyDirectoryTree::LazyDirectoryTree(const ArchiveIndex& index, const std::string& root_name)
+    : index(index), nodes(new Node[index.directory_count()]) {
+    auto root = std::make_shared<DirectoryEntry>();
+    root->name = root_name;
+    root->is_directory = true;
+    nodes[ROOT_DIR_ID].entry = std::move(root);
+}
+
+std::shared_ptr<DirectoryEntry> LazyDirectoryTree::get(DirId id) const {
+    if (id >= index.directory_count()) {
+        return nullptr;
+    }
+
+    // A directory's shell is created while its parent is populated
+    if (id != ROOT_DIR_ID) {
+        get(index.directory_parent(id));
+    }
+
+    Node& node = nodes[id];
+    std::call_once(node.populated, [this, id]() { populate(id); });
+    return node.entry;
+}
+
+void LazyDirectoryTree::populate(DirId id) const {
+    const auto& dir = nodes[id].entry;
+    std::string dir_path = index.directory_path(id);
+
+    EntryId first_file = index.first_file(id);
+    dir->files.reserve(index.file_count(id));
+    for (EntryId entry = first_file; entry < first_file + index.file_count(id); ++entry) {
+        dir->files.push_back(index.make_file_entry(entry, dir_path));
+    }
+
+    DirId first_subdir = index.first_subdirectory(id);
+    dir->subdirectories.reserve(index.subdirectory_count(id));
+    for (DirId subdir = first_subdir; subdir < first_subdir + index.subdirectory_count(id); ++subdir) {
+        auto shell = std::make_shared<DirectoryEntry>();
+        shell->name.assign(index.directory_name(subdir));
+        shell->is_directory = true;
+        shell->parent = dir;
+        nodes[subdir].entry = shell;
+        dir->subdirectories.push_back(std::move(shell));
+    }
+
+    materialized.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace unpaker
@@ -10,8 +10,18 @@
 #include "version.hpp"
 #include "logger.hpp"
 #include "config.hpp"
+#include "archive_diff.hpp"
+#include "archive_extractor.hpp"
+#include "entry_selector.hpp"
+#include "content_search.hpp"
+#include "text_index.hpp"
+#include "archive_watcher.hpp"
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <clocale>
 
 #ifndef NOMINMAX
@@ -19,6 +29,257 @@
 #endif
 #include <windows.h>
 
+// Reads the value of a numeric option; reports and returns false unless it is a whole number
+static bool parse_count(const std::string& option, const char* text, uint32_t& value) {
+    const char* end = text + std::strlen(text);
+    auto [ptr, ec] = std::from_chars(text, end, value);
+    if (ec != std::errc() || ptr != end || ptr == text) {
+        unpaker::Logger::instance().error("Invalid value for " + option + ": " + text);
+        return false;
+    }
+    return true;
+}
+
+// unPAKer --diff <old> <new> [--ndjson] [--confirm] [--all] [--output <file>]
+static int run_diff(int argc, char* argv[]) {
+    std::string old_path;
+    std::string new_path;
+    std::string output_path;
+    bool ndjson = false;
+    unpaker::DiffOptions options;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ndjson") {
+            ndjson = true;
+        } else if (arg == "--confirm") {
+            options.confirm_ambiguous = true;
+        } else if (arg == "--all") {
+            options.include_unchanged = true;
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (old_path.empty()) {
+            old_path = arg;
+        } else if (new_path.empty()) {
+            new_path = arg;
+        } else {
+            unpaker::Logger::instance().error("Unexpected argument: " + arg);
+            return 1;
+        }
+    }
+
+    if (old_path.empty() || new_path.empty()) {
+        unpaker::Logger::instance().error("Usage: unPAKer --diff <old> <new> [--ndjson] [--confirm] [--all] [--output <file>]");
+        return 1;
+    }
+
+    unpaker::PakParser old_archive(old_path);
+    unpaker::PakParser new_archive(new_path);
+    if (!old_archive.parse() || !new_archive.parse()) {
+        unpaker::Logger::instance().error("Failed to parse archives for diff");
+        return 1;
+    }
+
+    unpaker::ArchiveDiffResult result = unpaker::ArchiveDiff::compare(old_archive, new_archive, options);
+
+    std::ofstream file;
+    if (!output_path.empty()) {
+        file.open(output_path, std::ios::binary);
+        if (!file) {
+            unpaker::Logger::instance().error("Cannot open output file: " + output_path);
+            return 1;
+        }
+    }
+    std::ostream& out = output_path.empty() ? std::cout : file;
+
+    if (ndjson) {
+        unpaker::ArchiveDiff::write_ndjson(out, result);
+    } else {
+        unpaker::ArchiveDiff::write_text(out, result);
+    }
+    out.flush();
+
+    unpaker::Logger::instance().success("Diff completed in " + std::to_string(result.seconds) + "s");
+    return 0;
+}
+
+// unPAKer --extract <archive> <output dir> [--select <pattern>]... [--dedupe] [--threads <n>]
+static int run_extract(int argc, char* argv[]) {
+    std::string archive_path;
+    std::string output_dir;
+    unpaker::ExtractOptions options;
+    unpaker::EntrySelector selector;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--select" && i + 1 < argc) {
+            if (!selector.add(argv[++i])) {
+                return 1;
+            }
+        } else if (arg == "--dedupe") {
+            options.deduplicate = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!parse_count(arg, argv[++i], options.thread_count)) {
+                return 1;
+            }
+        } else if (archive_path.empty()) {
+            archive_path = arg;
+        } else if (output_dir.empty()) {
+            output_dir = arg;
+        } else {
+            unpaker::Logger::instance().error("Unexpected argument: " + arg);
+            return 1;
+        }
+    }
+
+    if (archive_path.empty() || output_dir.empty()) {
+        unpaker::Logger::instance().error("Usage: unPAKer --extract <archive> <output dir> [--select <pattern>]... [--dedupe] [--threads <n>]");
+        return 1;
+    }
+
+    unpaker::PakParser archive(archive_path);
+    if (!archive.parse()) {
+        unpaker::Logger::instance().error("Failed to parse archive: " + archive_path);
+        return 1;
+    }
+
+    unpaker::ExtractReport report;
+    if (selector.empty()) {
+        report = unpaker::ArchiveExtractor::extract_all(archive, output_dir, options);
+    } else {
+        std::vector<unpaker::EntryId> entries = selector.select(archive.get_index(), options.thread_count);
+        unpaker::Logger::instance().info("Selected " + std::to_string(entries.size()) + " of " +
+                                         std::to_string(archive.get_file_count()) + " files");
+        report = unpaker::ArchiveExtractor::extract(archive, entries, output_dir, options);
+    }
+    return report.failed_files == 0 ? 0 : 1;
+}
+
+// unPAKer --grep <archive> <text>... [--regex <re>] [-i] [--select <pattern>]... [--max <n>] [--output <file>]
+static int run_grep(int argc, char* argv[]) {
+    std::string archive_path;
+    std::string output_path;
+    unpaker::SearchOptions options;
+    unpaker::EntrySelector selector;
+    bool use_index = false;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--index") {
+            use_index = true;
+        } else if (arg == "--regex" && i + 1 < argc) {
+            options.regex = argv[++i];
+        } else if (arg == "-i") {
+            options.ignore_case = true;
+        } else if (arg == "--select" && i + 1 < argc) {
+            if (!selector.add(argv[++i])) {
+                return 1;
+            }
+        } else if (arg == "--max" && i + 1 < argc) {
+            if (!parse_count(arg, argv[++i], options.max_matches_per_entry)) {
+                return 1;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (archive_path.empty()) {
+            archive_path = arg;
+        } else {
+            options.literals.push_back(arg);
+        }
+    }
+
+    if (archive_path.empty() || (options.literals.empty() && options.regex.empty())) {
+        unpaker::Logger::instance().error("Usage: unPAKer --grep <archive> <text>... [--regex <re>] [-i] [--select <pattern>]... [--max <n>] [--index] [--output <file>]");
+        return 1;
+    }
+
+    unpaker::PakParser archive(archive_path);
+    if (!archive.parse()) {
+        unpaker::Logger::instance().error("Failed to parse archive: " + archive_path);
+        return 1;
+    }
+
+    unpaker::SearchResult result;
+    if (use_index) {
+        // Only text assets are indexed; the selector narrows the candidates further
+        unpaker::TextIndex text_index;
+        if (!text_index.open(archive, options.thread_count)) {
+            unpaker::Logger::instance().error("Failed to index archive: " + archive_path);
+            return 1;
+        }
+        std::vector<unpaker::EntryId> entries = options.literals.empty()
+            ? text_index.candidates(std::string_view())
+            : text_index.candidates(options.literals);
+        if (!selector.empty()) {
+            const unpaker::ArchiveIndex& index = archive.get_index();
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [&](unpaker::EntryId id) { return !selector.matches(index.path(id)); }),
+                          entries.end());
+        }
+        result = unpaker::ContentSearch::search(archive, entries, options);
+    } else if (selector.empty()) {
+        result = unpaker::ContentSearch::search(archive, options);
+    } else {
+        result = unpaker::ContentSearch::search(archive, selector.select(archive.get_index()), options);
+    }
+
+    std::ofstream file;
+    if (!output_path.empty()) {
+        file.open(output_path, std::ios::binary);
+        if (!file) {
+            unpaker::Logger::instance().error("Cannot open output file: " + output_path);
+            return 1;
+        }
+    }
+    std::ostream& out = output_path.empty() ? std::cout : file;
+    unpaker::ContentSearch::write_text(out, result);
+    out.flush();
+
+    unpaker::Logger::instance().success("Search completed in " + std::to_string(result.seconds) + "s");
+    return result.matches.empty() ? 1 : 0;
+}
+
+static int run_watch(int argc, char* argv[]) {
+    std::string archive_path;
+    unpaker::WatchOptions options;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            if (!parse_count(arg, argv[++i], options.thread_count)) {
+                return 1;
+            }
+        } else if (arg == "--settle" && i + 1 < argc) {
+            if (!parse_count(arg, argv[++i], options.settle_ms)) {
+                return 1;
+            }
+        } else if (archive_path.empty()) {
+            archive_path = arg;
+        } else {
+            unpaker::Logger::instance().error("Unexpected argument: " + arg);
+            return 1;
+        }
+    }
+
+    if (archive_path.empty()) {
+        unpaker::Logger::instance().error("Usage: unPAKer --watch <archive> [--settle <ms>] [--threads <n>]");
+        return 1;
+    }
+
+    unpaker::ArchiveWatcher watcher(archive_path, options);
+    if (!watcher.start()) {
+        return 1;
+    }
+
+    unpaker::Logger::instance().info("Press Enter to stop watching.");
+    std::string line;
+    std::getline(std::cin, line);
+    watcher.stop();
+
+    unpaker::Logger::instance().success("Stopped after " + std::to_string(watcher.generation() - 1) + " reloads");
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     typedef BOOL (WINAPI* SetProcessDpiAwarenessContextFunc)(DPI_AWARENESS_CONTEXT);
     HMODULE user32 = LoadLibraryW(L"user32.dll");
@@ -57,6 +318,30 @@ int main(int argc, char* argv[]) {
     unpaker::Logger::instance().info(std::string("License: ") + UNPAKER_LICENSE);
     unpaker::Logger::instance().info("========================================");
 
+    if (argc > 1 && std::string(argv[1]) == "--diff") {
+        int exit_code = run_diff(argc, argv);
+        unpaker::Logger::instance().shutdown();
+        return exit_code;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--grep") {
+        int exit_code = run_grep(argc, argv);
+        unpaker::Logger::instance().shutdown();
+        return exit_code;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--watch") {
+        int exit_code = run_watch(argc, argv);
+        unpaker::Logger::instance().shutdown();
+        return exit_code;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--extract") {
+        int exit_code = run_extract(argc, argv);
+        unpaker::Logger::instance().shutdown();
+        return exit_code;
+    }
+
     auto& app_manager = unpaker::ApplicationManager::getInstance();
     if (!app_manager.acquireInstance("unPAKer_SingleInstance")) {
         unpaker::Logger::instance().error("Failed to acquire application instance");
@@ -0,0 +1,171 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "mapped_file.hpp"
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace unpaker {
+
+MappedFile::MappedFile(const fs::path& path) {
+    open(path);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const fs::path& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[ERROR] MappedFile: Cannot open file: " << path.string() << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size)) {
+        std::cerr << "[ERROR] MappedFile: Cannot get file size: " << path.string() << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<uint64_t>(file_size.QuadPart);
+    opened_ = true;
+
+    if (size_ == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        std::cerr << "[ERROR] MappedFile: CreateFileMapping failed (error: " << GetLastError()
+                  << ") for " << path.string() << std::endl;
+        close();
+        return false;
+    }
+    mapping_handle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        std::cerr << "[ERROR] MappedFile: MapViewOfFile failed (error: " << GetLastError()
+                  << ") for " << path.string() << std::endl;
+        close();
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(view);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[ERROR] MappedFile: Cannot open file: " << path.string() << std::endl;
+        return false;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "[ERROR] MappedFile: Cannot get file size: " << path.string() << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    size_ = static_cast<uint64_t>(st.st_size);
+    opened_ = true;
+
+    if (size_ == 0) {
+        return true;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(size_), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "[ERROR] MappedFile: mmap failed for " << path.string() << std::endl;
+        close();
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(view);
+#endif
+
+    return true;
+}
+
+bool MappedFile::read(const fs::path& path) {
+    close();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] MappedFile: Cannot open file: " << path.string() << std::endl;
+        return false;
+    }
+
+    std::streamoff length = file.tellg();
+    if (length < 0) {
+        std::cerr << "[ERROR] MappedFile: Cannot get file size: " << path.string() << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> copy(static_cast<size_t>(length));
+    file.seekg(0);
+    if (!copy.empty() && !file.read(reinterpret_cast<char*>(copy.data()), length)) {
+        std::cerr << "[ERROR] MappedFile: Cannot read file: " << path.string() << std::endl;
+        return false;
+    }
+
+    copy_ = std::move(copy);
+    data_ = copy_.empty() ? nullptr : copy_.data();
+    size_ = copy_.size();
+    opened_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (!copy_.empty()) {
+        std::vector<uint8_t>().swap(copy_);
+        data_ = nullptr;
+    }
+
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        file_handle_ = nullptr;
+    }
+#else
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
+
+} // namespace unpaker
@@ -4,12 +4,15 @@
 
 #include "pak_parser.hpp"
 #include "logger.hpp"
+#include "index_cache.hpp"
+#include "lazy_directory_tree.hpp"
 #include "parsers/vpk_parser.hpp"
 #include "parsers/ue_parser.hpp"
 #include "parsers/generic_parser.hpp"
 #include <iostream>
 #include <cstring>
 #include <fstream>
+#include <algorithm>
 
 namespace unpaker {
 
@@ -18,17 +21,11 @@ PakParser::PakParser(const fs::path& pak_path)
               detected_format(PakFormat::UNKNOWN),
               file_count(0),
               archive_size(0),
-              current_parser(nullptr) {
-    root_directory = std::make_shared<DirectoryEntry>();
-    if (!root_directory) {
-        std::cerr << "[ERROR] Failed to allocate memory for root directory" << std::endl;
-        return;
-    }
-
-    root_directory->name = "/";
-    root_directory->is_directory = true;
-    root_directory->parent = nullptr;
-
+              current_parser(nullptr),
+              index_cache_enabled(true),
+              from_cache(false),
+              thread_count(0),
+              pin_files(false) {
     if (fs::exists(pak_path)) {
         try {
             archive_size = fs::file_size(pak_path);
@@ -72,18 +69,69 @@ bool PakParser::detect_format() {
     return false;
 }
 
+std::shared_ptr<parsers::BaseParser> PakParser::create_parser(PakFormat format) {
+    switch (format) {
+        case PakFormat::SOURCE_ENGINE:
+            return std::make_shared<parsers::VpkParser>();
+        case PakFormat::UNREAL_ENGINE_3:
+        case PakFormat::UNREAL_ENGINE_4_5:
+            return std::make_shared<parsers::UEParser>();
+        case PakFormat::GENERIC:
+            return std::make_shared<parsers::GenericParser>();
+        case PakFormat::UNKNOWN:
+        default:
+            return nullptr;
+    }
+}
+
+bool PakParser::load_cached_index() {
+    IndexCache cache;
+    ArchiveIndex cached_index;
+    uint32_t cached_count = 0;
+    uint32_t cached_format = 0;
+
+    if (!cache.load(archive_path, cached_index, cached_count, cached_format)) {
+        return false;
+    }
+
+    auto format = static_cast<PakFormat>(cached_format);
+    auto parser = create_parser(format);
+    if (!parser) {
+        return false;
+    }
+    parser->set_thread_count(thread_count);
+    parser->set_pin_files(pin_files);
+    if (pin_files) {
+        parser->open_pinned_files(archive_path);
+    }
+
+    index = std::move(cached_index);
+    file_count = cached_count;
+    detected_format = format;
+    current_parser = parser;
+    return true;
+}
+
 bool PakParser::parse() {
     Logger::instance().info("Attempting to parse archive...");
 
-    root_directory = std::make_shared<DirectoryEntry>();
-    if (!root_directory) {
-        std::cerr << "[ERROR] Failed to allocate root directory" << std::endl;
-        return false;
+    lazy_tree.reset();
+    index = ArchiveIndex();
+    path_lookup.clear();
+    {
+        std::lock_guard<std::mutex> lock(root_mutex);
+        root_directory.reset();
     }
-    root_directory->name = archive_path.filename().string();
-    root_directory->is_directory = true;
-    root_directory->parent = nullptr;
     file_count = 0;
+    from_cache = false;
+
+    if (index_cache_enabled && load_cached_index()) {
+        from_cache = true;
+        index_ready();
+        Logger::instance().success(std::string("Loaded ") + std::to_string(file_count) +
+                                   " entries from index cache (" + get_format_info() + ")");
+        return true;
+    }
 
     if (!detect_format()) {
         Logger::instance().warning("Could not detect format, trying generic parser...");
@@ -96,7 +144,15 @@ bool PakParser::parse() {
     bool parse_result = false;
 
     if (current_parser) {
-        parse_result = current_parser->parse(archive_path, root_directory, file_count);
+        ArchiveIndexBuilder builder;
+        current_parser->set_thread_count(thread_count);
+        current_parser->set_pin_files(pin_files);
+        parse_result = current_parser->parse(archive_path, builder, file_count);
+        if (parse_result && pin_files) {
+            current_parser->open_pinned_files(archive_path);
+        }
+        index = builder.finish();
+        index_ready();
     } else {
         std::cerr << "[ERROR] No parser available" << std::endl;
         return false;
@@ -104,8 +160,14 @@ bool PakParser::parse() {
 
     if (parse_result) {
         Logger::instance().success("Archive parsed successfully");
+        LOG_DEBUG("Index uses " + std::to_string(index.memory_usage()) + " bytes for " +
+                  std::to_string(index.entry_count()) + " entries in " +
+                  std::to_string(index.directory_count()) + " directories");
         if (file_count == 0) {
             Logger::instance().warning("No entries found. This might be a file list or metadata file");
+        } else if (index_cache_enabled) {
+            IndexCache cache;
+            cache.store(archive_path, index, file_count, static_cast<uint32_t>(detected_format));
         }
     } else {
         Logger::instance().error("Failed to parse archive");
@@ -114,40 +176,54 @@ bool PakParser::parse() {
     return parse_result;
 }
 
-bool PakParser::build_directory_tree() {
-    for (const auto& file : root_directory->files) {
-        std::string path = file->path;
-        auto current = root_directory;
+const ArchiveIndex& PakParser::get_index() const {
+    return index;
+}
 
-        size_t pos = 0;
-        while ((pos = path.find_first_of("/\\", pos)) != std::string::npos) {
-            std::string dir_name = path.substr(0, pos);
+EntryId PakParser::find(std::string_view path) const {
+    return path_lookup.find(index, path);
+}
 
-            auto it = std::find_if(
-                current->subdirectories.begin(),
-                current->subdirectories.end(),
-                [&dir_name](const auto& d) { return d->name == dir_name; }
-            );
+const std::vector<PathCollision>& PakParser::get_path_collisions() const {
+    return path_lookup.collisions();
+}
 
-            if (it == current->subdirectories.end()) {
-                auto new_dir = std::make_shared<DirectoryEntry>();
-                new_dir->name = dir_name;
-                new_dir->parent = current;
-                current->subdirectories.push_back(new_dir);
-                current = new_dir;
-            } else {
-                current = *it;
-            }
+void PakParser::index_ready() {
+    lazy_tree = std::make_unique<LazyDirectoryTree>(index, archive_path.filename().string());
+    path_lookup.build(index);
 
-            path = path.substr(pos + 1);
-            pos = 0;
-        }
+    const auto& collisions = path_lookup.collisions();
+    if (collisions.empty()) {
+        return;
     }
 
-    return true;
+    constexpr size_t MAX_REPORTED_COLLISIONS = 10;
+    Logger::instance().warning(std::to_string(collisions.size()) +
+                               " entries collide with another path when case is ignored");
+    for (size_t i = 0; i < collisions.size() && i < MAX_REPORTED_COLLISIONS; ++i) {
+        Logger::instance().warning("  " + index.path(collisions[i].shadowed) + " is shadowed by " +
+                                   index.path(collisions[i].kept));
+    }
+}
+
+std::shared_ptr<DirectoryEntry> PakParser::get_directory(DirId id) const {
+    return lazy_tree ? lazy_tree->get(id) : nullptr;
+}
+
+std::shared_ptr<DirectoryEntry> PakParser::get_directory(std::string_view path) const {
+    DirId id = find_directory(path);
+    return id != INVALID_DIR_ID ? get_directory(id) : nullptr;
+}
+
+DirId PakParser::find_directory(std::string_view path) const {
+    return PathLookup::find_directory(index, path);
 }
 
 std::shared_ptr<DirectoryEntry> PakParser::get_root() const {
+    std::lock_guard<std::mutex> lock(root_mutex);
+    if (!root_directory) {
+        root_directory = index.build_tree(archive_path.filename().string());
+    }
     return root_directory;
 }
 
@@ -179,6 +255,49 @@ uint64_t PakParser::get_archive_size() const {
     return archive_size;
 }
 
+const fs::path& PakParser::get_archive_path() const {
+    return archive_path;
+}
+
+void PakParser::set_index_cache_enabled(bool enabled) {
+    index_cache_enabled = enabled;
+}
+
+bool PakParser::has_entry_checksums() const {
+    return current_parser && current_parser->provides_crc32();
+}
+
+SectionChecksumReport PakParser::verify_section_checksums() const {
+    if (!current_parser) {
+        return SectionChecksumReport();
+    }
+
+    try {
+        return current_parser->verify_section_checksums(archive_path);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Exception in verify_section_checksums: " << e.what() << std::endl;
+        SectionChecksumReport report;
+        report.present = true;
+        report.failures.push_back(e.what());
+        return report;
+    }
+}
+
+bool PakParser::loaded_from_cache() const {
+    return from_cache;
+}
+
+void PakParser::set_thread_count(uint32_t count) {
+    thread_count = count;
+    if (current_parser) {
+        current_parser->set_thread_count(count);
+    }
+}
+
+void PakParser::set_pin_files(bool enabled) {
+    pin_files = enabled;
+}
+
 bool PakParser::extract_file(const std::shared_ptr<FileEntry>& file, std::vector<uint8_t>& data) const {
     if (!file || !current_parser) {
         std::cerr << "[ERROR] Invalid file or no parser available" << std::endl;
@@ -193,5 +312,98 @@ bool PakParser::extract_file(const std::shared_ptr<FileEntry>& file, std::vector
     }
 }
 
+bool PakParser::extract_entry(EntryId id, std::vector<uint8_t>& data) const {
+    if (id >= index.entry_count()) {
+        std::cerr << "[ERROR] Invalid entry id: " << id << std::endl;
+        return false;
+    }
+
+    return extract_file(index.make_file_entry(id), data);
+}
+
+bool PakParser::extract_file(const std::shared_ptr<FileEntry>& file, uint8_t* buffer, size_t capacity,
+                             size_t& bytes_read) const {
+    bytes_read = 0;
+    if (!file || !current_parser) {
+        std::cerr << "[ERROR] Invalid file or no parser available" << std::endl;
+        return false;
+    }
+
+    try {
+        return current_parser->extract_into(archive_path, file, buffer, capacity, bytes_read);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Exception in extract_file: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool PakParser::extract_entry(EntryId id, uint8_t* buffer, size_t capacity, size_t& bytes_read) const {
+    bytes_read = 0;
+    if (id >= index.entry_count()) {
+        std::cerr << "[ERROR] Invalid entry id: " << id << std::endl;
+        return false;
+    }
+
+    // Only the location is filled in: the path would cost an allocation per entry, so it is
+    // reported here instead if the read fails
+    EntryRecord record = index.record(id);
+    FileEntry entry;
+    entry.offset = record.offset;
+    entry.size = record.size;
+    entry.is_directory = false;
+    entry.archive_index = record.archive_index;
+    entry.storage = record.storage;
+    entry.crc = record.crc;
+    entry.preload_offset = record.preload_offset;
+    entry.preload_size = record.preload_size;
+
+    // Non-owning pointer to the stack entry, which outlives the call
+    std::shared_ptr<FileEntry> file(std::shared_ptr<FileEntry>(), &entry);
+    if (!extract_file(file, buffer, capacity, bytes_read)) {
+        std::cerr << "[ERROR] Failed to extract " << index.path(id) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+EntryStream PakParser::open_file(const std::shared_ptr<FileEntry>& file) const {
+    if (!current_parser) {
+        std::cerr << "[ERROR] No parser available for streaming" << std::endl;
+        return EntryStream();
+    }
+
+    try {
+        return current_parser->open_entry(archive_path, file);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Exception in open_file: " << e.what() << std::endl;
+        return EntryStream();
+    }
+}
+
+EntryStream PakParser::open_entry(EntryId id) const {
+    if (id >= index.entry_count()) {
+        std::cerr << "[ERROR] Invalid entry id: " << id << std::endl;
+        return EntryStream();
+    }
+
+    return open_file(index.make_file_entry(id));
+}
+
+size_t PakParser::extract_files(const std::vector<std::shared_ptr<FileEntry>>& files,
+                                const ExtractCallback& on_extracted,
+                                uint32_t read_threads) const {
+    if (!current_parser) {
+        std::cerr << "[ERROR] No parser available for batch extraction" << std::endl;
+        return 0;
+    }
+
+    try {
+        return current_parser->extract_files(archive_path, files, on_extracted, read_threads);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Exception in extract_files: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
 
 }
@@ -6,6 +6,7 @@
 #include "logger.hpp"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <vector>
 
 namespace unpaker::parsers {
@@ -16,7 +17,7 @@ bool GenericParser::detect(const fs::path&) {
 }
 
 bool GenericParser::parse(const fs::path&,
-                                                 std::shared_ptr<DirectoryEntry>&,
+                                                 ArchiveIndexBuilder&,
                                                  uint32_t&) {
     Logger::instance().error("Generic: No specific parser matched this archive format");
     return false;
@@ -31,27 +32,18 @@ bool GenericParser::extract_file(const fs::path& archive_path,
     }
 
     try {
-        std::ifstream ifs(archive_path, std::ios::binary);
-        if (!ifs.is_open()) {
-            std::cerr << "[ERROR] Generic: Failed to open archive file: " << archive_path.string() << std::endl;
-            return false;
-        }
-
-        ifs.seekg(file->offset, std::ios::beg);
-        if (!ifs.good()) {
-            std::cerr << "[ERROR] Generic: Failed to seek to file offset: " << file->offset << std::endl;
-            return false;
-        }
-
         data.resize(file->size);
-        ifs.read(reinterpret_cast<char*>(data.data()), file->size);
-
-        if (!ifs.good() && !ifs.eof()) {
-            std::cerr << "[ERROR] Generic: Failed to read file data" << std::endl;
-            return false;
+        size_t bytes_read = 0;
+        if (!extract_into(archive_path, file, data.data(), data.size(), bytes_read)) {
+            if (bytes_read == 0 && file->size > 0) {
+                std::cerr << "[ERROR] Generic: Failed to read file data" << std::endl;
+                return false;
+            }
+            // Entries running past the end of the archive keep a zero-filled tail
+            std::fill(data.begin() + bytes_read, data.end(), 0);
+            std::cerr << "[WARNING] Generic: Read " << bytes_read << " of " << file->size
+                                      << " bytes for " << file->path << std::endl;
         }
-
-        ifs.close();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] Generic: Exception in extract_file: " << e.what() << std::endl;
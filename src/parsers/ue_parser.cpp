@@ -3,16 +3,367 @@
 // Licensed under MIT License
 
 #include "ue_parser.hpp"
+#include "ue_format.hpp"
 #include "logger.hpp"
 #include <fstream>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace unpaker::parsers {
 
+namespace {
+
+// offset, size, uncompressed size, compression, hash, flags and block size of an uncompressed entry
+constexpr size_t MIN_ENTRY_RECORD_SIZE = 3 * 8 + 1 + ue::HASH_SIZE;
+// A file in the full directory index: its name length (the name may be empty) and entry location
+constexpr size_t MIN_DIRECTORY_FILE_SIZE = 4 + 4;
+
+class IndexReader {
+public:
+    IndexReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (sizeof(T) > size - pos) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool skip(uint64_t length) {
+        if (length > size - pos) return false;
+        pos += static_cast<size_t>(length);
+        return true;
+    }
+
+    bool seek(size_t position) {
+        if (position > size) return false;
+        pos = position;
+        return true;
+    }
+
+    // FString: a length counting the terminator, negative for UTF-16 text
+    bool read_string(std::string& text) {
+        int32_t length = 0;
+        if (!read(length)) return false;
+        text.clear();
+        if (length == 0) return true;
+
+        if (length > 0) {
+            if (static_cast<uint64_t>(length) > size - pos) return false;
+            const char* chars = reinterpret_cast<const char*>(data + pos);
+            text.assign(chars, strnlen(chars, static_cast<size_t>(length)));
+            pos += static_cast<size_t>(length);
+            return true;
+        }
+
+        uint64_t units = static_cast<uint64_t>(-static_cast<int64_t>(length));
+        if (units * 2 > size - pos) return false;
+        for (uint64_t i = 0; i < units; ++i) {
+            uint32_t code = static_cast<uint32_t>(data[pos] | (data[pos + 1] << 8));
+            pos += 2;
+            if (code == 0) {
+                pos += static_cast<size_t>((units - i - 1) * 2);
+                break;
+            }
+            if (code >= 0xD800 && code < 0xDC00 && i + 1 < units) {
+                uint32_t low = static_cast<uint32_t>(data[pos] | (data[pos + 1] << 8));
+                if (low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    pos += 2;
+                    ++i;
+                }
+            }
+            append_utf8(text, code);
+        }
+        return true;
+    }
+
+    size_t position() const { return pos; }
+    size_t remaining() const { return size - pos; }
+
+private:
+    static void append_utf8(std::string& text, uint32_t code) {
+        if (code < 0x80) {
+            text += static_cast<char>(code);
+        } else if (code < 0x800) {
+            text += static_cast<char>(0xC0 | (code >> 6));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            text += static_cast<char>(0xE0 | (code >> 12));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            text += static_cast<char>(0xF0 | (code >> 18));
+            text += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+struct PakEntry {
+    // Position of the FPakEntry header that precedes the data
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint64_t uncompressed_size = 0;
+    // From v8 a 1-based index into the footer's method names, before that COMPRESS_* flags
+    uint32_t compression = 0;
+    uint8_t flags = 0;
+    // Length of that header, which is the entry serialized the same way as in the index
+    uint32_t header_size = 0;
+};
+
+// FPakEntry as serialized in the index and in front of every entry's data
+bool read_entry(IndexReader& reader, const UEParser::PakInfo& info, PakEntry& entry) {
+    size_t start = reader.position();
+    entry = PakEntry();
+
+    if (!reader.read(entry.offset) || !reader.read(entry.size) || !reader.read(entry.uncompressed_size)) {
+        return false;
+    }
+    if (info.byte_compression_index) {
+        uint8_t method = 0;
+        if (!reader.read(method)) return false;
+        entry.compression = method;
+    } else if (!reader.read(entry.compression)) {
+        return false;
+    }
+    if (info.version <= ue::VERSION_INITIAL && !reader.skip(8)) {
+        return false;
+    }
+    if (!reader.skip(ue::HASH_SIZE)) {
+        return false;
+    }
+    if (info.version >= ue::VERSION_COMPRESSION_ENCRYPTION) {
+        if (entry.compression != 0) {
+            int32_t block_count = 0;
+            if (!reader.read(block_count) || block_count < 0 ||
+                !reader.skip(static_cast<uint64_t>(block_count) * 16)) {
+                return false;
+            }
+        }
+        uint32_t block_size = 0;
+        if (!reader.read(entry.flags) || !reader.read(block_size)) {
+            return false;
+        }
+    }
+
+    entry.header_size = static_cast<uint32_t>(reader.position() - start);
+    return true;
+}
+
+// Bit-packed entry of the v10+ encoded entry table
+bool decode_entry(const uint8_t* table, size_t table_size, size_t position, PakEntry& entry) {
+    IndexReader reader(table, table_size);
+    uint32_t bits = 0;
+    if (!reader.seek(position) || !reader.read(bits)) {
+        return false;
+    }
+    entry = PakEntry();
+
+    // Low six bits hold the block size in 2 KiB units, or 0x3f when it follows as a u32
+    if ((bits & 0x3f) == 0x3f && !reader.skip(4)) {
+        return false;
+    }
+    entry.compression = (bits >> 23) & 0x3f;
+
+    auto read_field = [&](bool is_32bit, uint64_t& value) {
+        if (is_32bit) {
+            uint32_t narrow = 0;
+            if (!reader.read(narrow)) return false;
+            value = narrow;
+            return true;
+        }
+        return reader.read(value);
+    };
+    if (!read_field((bits & (1u << 31)) != 0, entry.offset) ||
+        !read_field((bits & (1u << 30)) != 0, entry.uncompressed_size)) {
+        return false;
+    }
+    if (entry.compression != 0) {
+        if (!read_field((bits & (1u << 29)) != 0, entry.size)) return false;
+    } else {
+        entry.size = entry.uncompressed_size;
+    }
+    if (bits & (1u << 22)) {
+        entry.flags |= ue::ENTRY_FLAG_ENCRYPTED;
+    }
+
+    // The header written in front of the data is the v10 FPakEntry with this many blocks
+    uint32_t block_count = (bits >> 6) & 0xffff;
+    entry.header_size = 3 * 8 + 4 + ue::HASH_SIZE + (entry.compression != 0 ? 4 + 16 * block_count : 0) + 1 + 4;
+    return true;
+}
+
+// Mount points are written relative to the engine binaries ("../../../Game/"); paths are listed
+// from the part after that
+std::string normalize_mount_point(const std::string& mount_point) {
+    size_t start = 0;
+    while (mount_point.compare(start, 3, "../") == 0) {
+        start += 3;
+    }
+    while (start < mount_point.size() && (mount_point[start] == '/' || mount_point[start] == '\\')) {
+        ++start;
+    }
+    std::string prefix = mount_point.substr(start);
+    if (!prefix.empty() && prefix.back() != '/') {
+        prefix += '/';
+    }
+    return prefix;
+}
+
+// Adds decoded entries under the mount point and counts the ones that cannot be extracted
+class EntrySink {
+public:
+    EntrySink(ArchiveIndexBuilder& index, std::string mount_prefix)
+        : index(index), mount_prefix(std::move(mount_prefix)) {}
+
+    void add(std::string_view directory, std::string_view name, const PakEntry& entry) {
+        if (entry.flags & ue::ENTRY_FLAG_DELETED) {
+            deleted++;
+            return;
+        }
+        if (entry.uncompressed_size > std::numeric_limits<uint32_t>::max()) {
+            oversized++;
+            return;
+        }
+
+        path.assign(mount_prefix);
+        if (directory != "/") path.append(directory);
+        path.append(name);
+        size_t start = path.find_first_not_of('/');
+        if (start == std::string::npos) return;
+
+        EntryRecord record;
+        record.size = static_cast<uint32_t>(entry.uncompressed_size);
+        if (entry.flags & ue::ENTRY_FLAG_ENCRYPTED) {
+            record.offset = entry.offset;
+            record.storage = STORAGE_ENCRYPTED;
+            encrypted++;
+        } else if (entry.compression != 0) {
+            record.offset = entry.offset;
+            record.storage = STORAGE_COMPRESSED;
+            compressed++;
+        } else {
+            record.offset = entry.offset + entry.header_size;
+        }
+
+        index.add(std::string_view(path).substr(start), record);
+        added++;
+    }
+
+    void report() const {
+        if (compressed > 0 || encrypted > 0) {
+            Logger::instance().warning("UE: " + std::to_string(compressed) + " compressed and " +
+                                       std::to_string(encrypted) + " encrypted entries are listed but cannot be extracted");
+        }
+        if (oversized > 0) {
+            std::cerr << "[WARNING] UE: Skipped " << oversized << " entries larger than 4 GiB" << std::endl;
+        }
+        DEBUG_COUT("[DEBUG] UE: " << added << " entries added, " << deleted << " delete records skipped" << std::endl);
+    }
+
+    uint32_t added = 0;
+
+private:
+    ArchiveIndexBuilder& index;
+    std::string mount_prefix;
+    std::string path;
+    uint32_t compressed = 0;
+    uint32_t encrypted = 0;
+    uint32_t deleted = 0;
+    uint32_t oversized = 0;
+};
+
+} // namespace
+
+bool UEParser::read_pak_info(const RandomAccessFile& file, PakInfo& info) {
+    uint64_t file_size = file.size();
+    uint8_t tail[ue::MAX_FOOTER_SIZE];
+    size_t tail_size = static_cast<size_t>(std::min<uint64_t>(file_size, ue::MAX_FOOTER_SIZE));
+    if (tail_size < ue::FOOTER_SIZE_V3 || file.read_at(file_size - tail_size, tail, tail_size) != tail_size) {
+        return false;
+    }
+
+    struct Layout {
+        uint32_t size;
+        uint32_t min_version;
+        uint32_t max_version;
+    };
+    // Longest first: a shorter layout would find the magic of a longer footer misaligned anyway
+    static constexpr Layout LAYOUTS[] = {
+        {ue::FOOTER_SIZE_V9, ue::VERSION_FROZEN_INDEX, ue::VERSION_FROZEN_INDEX},
+        {ue::FOOTER_SIZE_V8, ue::VERSION_FNAME_BASED_COMPRESSION, ue::VERSION_FNV64_BUG_FIX},
+        {ue::FOOTER_SIZE_V8_422, ue::VERSION_FNAME_BASED_COMPRESSION, ue::VERSION_FNAME_BASED_COMPRESSION},
+        {ue::FOOTER_SIZE_V7, ue::VERSION_ENCRYPTION_KEY_GUID, ue::VERSION_ENCRYPTION_KEY_GUID},
+        {ue::FOOTER_SIZE_V4, ue::VERSION_INDEX_ENCRYPTION, ue::VERSION_ENCRYPTION_KEY_GUID - 1},
+        {ue::FOOTER_SIZE_V3, ue::VERSION_INITIAL, ue::VERSION_COMPRESSION_ENCRYPTION},
+    };
+
+    for (const Layout& layout : LAYOUTS) {
+        if (layout.size > tail_size) continue;
+        const uint8_t* footer = tail + tail_size - layout.size;
+
+        size_t pos = layout.size >= ue::FOOTER_SIZE_V7 ? ue::GUID_SIZE : 0;
+        uint8_t encrypted_index = 0;
+        if (layout.size >= ue::FOOTER_SIZE_V4) {
+            encrypted_index = footer[pos++];
+        }
+
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t index_offset = 0;
+        uint64_t index_size = 0;
+        std::memcpy(&magic, footer + pos, 4);
+        std::memcpy(&version, footer + pos + 4, 4);
+        std::memcpy(&index_offset, footer + pos + 8, 8);
+        std::memcpy(&index_size, footer + pos + 16, 8);
+        pos += 24 + ue::HASH_SIZE;
+
+        if (magic != ue::PAK_MAGIC || version < layout.min_version || version > layout.max_version ||
+            (layout.size == ue::FOOTER_SIZE_V8 && version == ue::VERSION_FROZEN_INDEX) || encrypted_index > 1) {
+            continue;
+        }
+        uint64_t footer_offset = file_size - layout.size;
+        if (index_offset > footer_offset || index_size > footer_offset - index_offset) {
+            continue;
+        }
+
+        info = PakInfo();
+        info.version = version;
+        info.footer_size = layout.size;
+        info.index_offset = index_offset;
+        info.index_size = index_size;
+        info.encrypted_index = encrypted_index != 0;
+        info.byte_compression_index = layout.size == ue::FOOTER_SIZE_V8_422;
+        if (version == ue::VERSION_FROZEN_INDEX) {
+            info.frozen_index = footer[pos++] != 0;
+        }
+        for (; pos + ue::COMPRESSION_NAME_SIZE <= layout.size; pos += ue::COMPRESSION_NAME_SIZE) {
+            const char* name = reinterpret_cast<const char*>(footer + pos);
+            info.compression_methods.emplace_back(name, strnlen(name, ue::COMPRESSION_NAME_SIZE));
+        }
+        return true;
+    }
+    return false;
+}
+
 bool UEParser::detect(const fs::path& archive_path) {
+    RandomAccessFile pak;
+    PakInfo info;
+    if (pak.open(archive_path) && read_pak_info(pak, info)) {
+        Logger::instance().info("UE Parser: Detected Unreal Engine 4/5 pak, version " + std::to_string(info.version));
+        return true;
+    }
+
     std::ifstream file(archive_path, std::ios::binary);
     if (!file) return false;
 
@@ -46,8 +397,205 @@ std::string UEParser::read_cstring(std::FILE* file, size_t offset) {
 }
 
 bool UEParser::parse(const fs::path& archive_path,
-                    std::shared_ptr<DirectoryEntry>& root,
+                    ArchiveIndexBuilder& index,
                     uint32_t& file_count) {
+    RandomAccessFile pak;
+    if (!pak.open(archive_path)) {
+        std::cerr << "[ERROR] UE: Cannot open file: " << archive_path.string() << std::endl;
+        return false;
+    }
+
+    PakInfo info;
+    if (!read_pak_info(pak, info)) {
+        LOG_DEBUG("UE: No pak footer found, reading headerless layout");
+        pak.close();
+        return parse_headerless(archive_path, index, file_count);
+    }
+
+    Logger::instance().info("UE: Parsing pak version " + std::to_string(info.version) + ", index of " +
+                            std::to_string(info.index_size) + " bytes at " + std::to_string(info.index_offset));
+    if (info.encrypted_index) {
+        std::cerr << "[ERROR] UE: The pak index is encrypted; it cannot be read without the game's AES key" << std::endl;
+        return false;
+    }
+    if (info.frozen_index) {
+        std::cerr << "[ERROR] UE: Frozen pak indexes (UE 4.25 v9) are not supported" << std::endl;
+        return false;
+    }
+
+    // The whole index comes in with one read and is decoded in memory
+    std::vector<uint8_t> primary_index;
+    try {
+        primary_index.resize(static_cast<size_t>(info.index_size));
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[ERROR] UE: Memory allocation failed" << std::endl;
+        return false;
+    }
+    if (pak.read_at(info.index_offset, primary_index.data(), primary_index.size()) != primary_index.size()) {
+        std::cerr << "[ERROR] UE: Failed to read the pak index" << std::endl;
+        return false;
+    }
+
+    try {
+        if (info.version >= ue::VERSION_PATH_HASH_INDEX) {
+            return parse_path_hash_index(pak, info, primary_index, index, file_count);
+        }
+        return parse_entry_list(info, primary_index, index, file_count);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[ERROR] UE: Memory allocation failed" << std::endl;
+        return false;
+    }
+}
+
+bool UEParser::parse_entry_list(const PakInfo& info,
+                                const std::vector<uint8_t>& primary_index,
+                                ArchiveIndexBuilder& index,
+                                uint32_t& file_count) {
+    IndexReader reader(primary_index.data(), primary_index.size());
+    std::string mount_point;
+    int32_t entry_count = 0;
+    if (!reader.read_string(mount_point) || !reader.read(entry_count) || entry_count < 0) {
+        std::cerr << "[ERROR] UE: Malformed pak index header" << std::endl;
+        return false;
+    }
+    DEBUG_COUT("[DEBUG] UE: Mount point " << mount_point << ", " << entry_count << " entries" << std::endl);
+
+    // A corrupt count cannot reserve more than the index has room for
+    index.reserve(std::min<size_t>(static_cast<size_t>(entry_count), reader.remaining() / (4 + MIN_ENTRY_RECORD_SIZE)));
+
+    EntrySink sink(index, normalize_mount_point(mount_point));
+    std::string name;
+    PakEntry entry;
+    int32_t read_count = 0;
+    for (; read_count < entry_count; ++read_count) {
+        if (!reader.read_string(name) || !read_entry(reader, info, entry)) {
+            std::cerr << "[WARNING] UE: Pak index ends after " << read_count << " of " << entry_count
+                      << " entries" << std::endl;
+            break;
+        }
+        sink.add(std::string_view(), name, entry);
+    }
+
+    sink.report();
+    file_count += sink.added;
+    Logger::instance().info("UE: Successfully parsed " + std::to_string(sink.added) + " file entries");
+    return read_count == entry_count || sink.added > 0;
+}
+
+bool UEParser::parse_path_hash_index(const RandomAccessFile& file,
+                                     const PakInfo& info,
+                                     const std::vector<uint8_t>& primary_index,
+                                     ArchiveIndexBuilder& index,
+                                     uint32_t& file_count) {
+    IndexReader reader(primary_index.data(), primary_index.size());
+    std::string mount_point;
+    int32_t entry_count = 0;
+    uint64_t path_hash_seed = 0;
+    uint32_t has_path_hash_index = 0;
+    uint32_t has_directory_index = 0;
+    uint64_t directory_index_offset = 0;
+    uint64_t directory_index_size = 0;
+    int32_t encoded_size = 0;
+
+    // Path hash index (lookup by hash only) is skipped; names come from the full directory index
+    bool valid = reader.read_string(mount_point) && reader.read(entry_count) && entry_count >= 0 &&
+                 reader.read(path_hash_seed) && reader.read(has_path_hash_index) &&
+                 (!has_path_hash_index || reader.skip(8 + 8 + ue::HASH_SIZE)) &&
+                 reader.read(has_directory_index) &&
+                 (!has_directory_index || (reader.read(directory_index_offset) &&
+                                           reader.read(directory_index_size) && reader.skip(ue::HASH_SIZE))) &&
+                 reader.read(encoded_size) && encoded_size >= 0;
+    const uint8_t* encoded_entries = primary_index.data() + reader.position();
+    valid = valid && reader.skip(static_cast<uint64_t>(encoded_size));
+
+    int32_t plain_count = 0;
+    std::vector<PakEntry> plain_entries;
+    if (valid && reader.read(plain_count) && plain_count >= 0) {
+        plain_entries.resize(std::min<size_t>(static_cast<size_t>(plain_count), reader.remaining() / MIN_ENTRY_RECORD_SIZE));
+        valid = plain_entries.size() == static_cast<size_t>(plain_count);
+        for (size_t i = 0; valid && i < plain_entries.size(); ++i) {
+            valid = read_entry(reader, info, plain_entries[i]);
+        }
+    } else {
+        valid = false;
+    }
+    if (!valid) {
+        std::cerr << "[ERROR] UE: Malformed pak index header" << std::endl;
+        return false;
+    }
+    DEBUG_COUT("[DEBUG] UE: Mount point " << mount_point << ", " << entry_count << " entries, "
+               << encoded_size << " bytes encoded, " << plain_count << " unencoded" << std::endl);
+
+    if (!has_directory_index) {
+        std::cerr << "[ERROR] UE: Pak has no full directory index; its entry names are stored only as hashes" << std::endl;
+        return false;
+    }
+    if (directory_index_offset > file.size() || directory_index_size > file.size() - directory_index_offset) {
+        std::cerr << "[ERROR] UE: Directory index lies outside the pak" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> directory_index(static_cast<size_t>(directory_index_size));
+    if (file.read_at(directory_index_offset, directory_index.data(), directory_index.size()) != directory_index.size()) {
+        std::cerr << "[ERROR] UE: Failed to read the directory index" << std::endl;
+        return false;
+    }
+
+    // As in parse_entry_list, a corrupt count cannot reserve more than the directory index names
+    index.reserve(std::min<size_t>(static_cast<size_t>(entry_count), directory_index.size() / MIN_DIRECTORY_FILE_SIZE));
+    EntrySink sink(index, normalize_mount_point(mount_point));
+
+    // Directory name, then each file name with the location of its entry: an offset into the
+    // encoded table, or -(i + 1) for unencoded entry i
+    IndexReader directories(directory_index.data(), directory_index.size());
+    int32_t directory_count = 0;
+    valid = directories.read(directory_count) && directory_count >= 0;
+    std::string directory;
+    std::string name;
+    PakEntry entry;
+    uint32_t bad_locations = 0;
+    for (int32_t d = 0; valid && d < directory_count; ++d) {
+        int32_t files_in_directory = 0;
+        valid = directories.read_string(directory) && directories.read(files_in_directory) && files_in_directory >= 0;
+        for (int32_t f = 0; valid && f < files_in_directory; ++f) {
+            int32_t location = 0;
+            valid = directories.read_string(name) && directories.read(location);
+            if (!valid) break;
+
+            bool found = false;
+            if (location >= 0) {
+                found = decode_entry(encoded_entries, static_cast<size_t>(encoded_size), static_cast<size_t>(location), entry);
+            } else if (location != std::numeric_limits<int32_t>::min()) {
+                size_t plain_index = static_cast<size_t>(-(static_cast<int64_t>(location) + 1));
+                if (plain_index < plain_entries.size()) {
+                    entry = plain_entries[plain_index];
+                    found = true;
+                }
+            }
+            if (!found) {
+                bad_locations++;
+                continue;
+            }
+            sink.add(directory, name, entry);
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "[WARNING] UE: Directory index ends early after " << sink.added << " entries" << std::endl;
+    }
+    if (bad_locations > 0) {
+        std::cerr << "[WARNING] UE: " << bad_locations << " directory index entries point nowhere" << std::endl;
+    }
+
+    sink.report();
+    file_count += sink.added;
+    Logger::instance().info("UE: Successfully parsed " + std::to_string(sink.added) + " file entries");
+    return valid || sink.added > 0;
+}
+
+bool UEParser::parse_headerless(const fs::path& archive_path,
+                                ArchiveIndexBuilder& index,
+                                uint32_t& file_count) {
     FILE* file;
     errno_t err = fopen_s(&file, archive_path.string().c_str(), "rb");
     if (err != 0 || !file) {
@@ -80,9 +628,13 @@ bool UEParser::parse(const fs::path& archive_path,
     DEBUG_COUT("[DEBUG] UE: Entry count from header: " << entry_count << std::endl);
     DEBUG_COUT("[DEBUG] UE: File size: " << file_size << " bytes" << std::endl);
 
-    if (entry_count > 100000) {
-        Logger::instance().warning(std::string("UE: Suspicious entry count: ") + std::to_string(entry_count) + std::string(", adjusting to 256"));
-        entry_count = 256;
+    // Each entry takes at least 21 bytes; a larger count is garbage and the walk below stops at
+    // the first invalid entry anyway
+    uint64_t max_entries = (file_size - 8) / 21;
+    if (entry_count > max_entries) {
+        Logger::instance().warning(std::string("UE: Suspicious entry count: ") + std::to_string(entry_count) +
+                                   std::string(", reading until the first invalid entry"));
+        entry_count = static_cast<uint32_t>(max_entries);
     }
 
     std::fseek(file, 4, SEEK_SET);
@@ -114,25 +666,24 @@ bool UEParser::parse(const fs::path& archive_path,
             continue;
         }
 
-        auto entry = std::make_shared<FileEntry>();
-        if (!entry) {
-            std::cerr << "[ERROR] UE: Memory allocation failed" << std::endl;
-            std::fclose(file);
-            return false;
+        std::string_view entry_path(path, strnlen(path, path_len));
+        if (entry_path.empty()) {
+            continue;
         }
 
-        entry->name = path;
-        entry->path = path;
-        entry->offset = static_cast<uint32_t>(offset);
-        entry->size = static_cast<uint32_t>(size);
-        entry->archive_index = 0x7fff;
-        entry->is_directory = false;
+        EntryRecord record;
+        record.offset = offset;
+        record.size = static_cast<uint32_t>(size);
 
-        if (!entry->name.empty()) {
-            root->files.push_back(entry);
-            file_count++;
-            file_count_local++;
+        try {
+            index.add(entry_path, record);
+        } catch (const std::bad_alloc&) {
+            std::cerr << "[ERROR] UE: Memory allocation failed" << std::endl;
+            std::fclose(file);
+            return false;
         }
+        file_count++;
+        file_count_local++;
     }
 
     Logger::instance().info(std::string("UE: Successfully parsed ") + std::to_string(file_count_local) + std::string(" file entries"));
@@ -150,27 +701,18 @@ bool UEParser::extract_file(const fs::path& archive_path,
     }
 
     try {
-        std::ifstream ifs(archive_path, std::ios::binary);
-        if (!ifs.is_open()) {
-            std::cerr << "[ERROR] UE: Failed to open archive file: " << archive_path.string() << std::endl;
-            return false;
-        }
-
-        ifs.seekg(file->offset, std::ios::beg);
-        if (!ifs.good()) {
-            std::cerr << "[ERROR] UE: Failed to seek to file offset: " << file->offset << std::endl;
-            return false;
-        }
-
         data.resize(file->size);
-        ifs.read(reinterpret_cast<char*>(data.data()), file->size);
-
-        if (!ifs.good() && !ifs.eof()) {
-            std::cerr << "[ERROR] UE: Failed to read file data" << std::endl;
-            return false;
+        size_t bytes_read = 0;
+        if (!extract_into(archive_path, file, data.data(), data.size(), bytes_read)) {
+            if (bytes_read == 0 && file->size > 0) {
+                std::cerr << "[ERROR] UE: Failed to read file data" << std::endl;
+                return false;
+            }
+            // Entries running past the end of the archive keep a zero-filled tail
+            std::fill(data.begin() + bytes_read, data.end(), 0);
+            std::cerr << "[WARNING] UE: Read " << bytes_read << " of " << file->size
+                                      << " bytes for " << file->path << std::endl;
         }
-
-        ifs.close();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] UE: Exception in extract_file: " << e.what() << std::endl;
@@ -178,4 +720,30 @@ bool UEParser::extract_file(const fs::path& archive_path,
     }
 }
 
+bool UEParser::extract_into(const fs::path& archive_path,
+                            const std::shared_ptr<FileEntry>& file,
+                            uint8_t* buffer,
+                            size_t capacity,
+                            size_t& bytes_read) const {
+    bytes_read = 0;
+    if (file && file->storage == STORAGE_COMPRESSED) {
+        std::cerr << "[ERROR] UE: Compressed pak entries cannot be extracted yet: " << file->path << std::endl;
+        return false;
+    }
+    if (file && file->storage == STORAGE_ENCRYPTED) {
+        std::cerr << "[ERROR] UE: Entry is encrypted and needs the game's AES key: " << file->path << std::endl;
+        return false;
+    }
+    return BaseParser::extract_into(archive_path, file, buffer, capacity, bytes_read);
+}
+
+EntryStream UEParser::open_entry(const fs::path& archive_path,
+                                 const std::shared_ptr<FileEntry>& file) const {
+    if (file && file->storage != STORAGE_PLAIN) {
+        std::cerr << "[ERROR] UE: Entry is compressed or encrypted and cannot be read: " << file->path << std::endl;
+        return EntryStream();
+    }
+    return BaseParser::open_entry(archive_path, file);
+}
+
 } // namespace unpaker::parsers
@@ -3,15 +3,30 @@
 // Licensed under MIT License
 
 #include "vpk_parser.hpp"
+#include "vpk_format.hpp"
 #include "logger.hpp"
+#include "thread_pool.hpp"
+#include "md5.hpp"
+#include "async_reader.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <cstring>
+#include <cctype>
 #include <algorithm>
 #include <map>
 #include <vector>
 #include <utility>
+#include <chrono>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNPAKER_TREE_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace unpaker::parsers {
 
@@ -29,12 +44,12 @@ bool VpkParser::detect(const fs::path& archive_path) {
     oss << "VPK: File signature: 0x" << std::hex << magic_int << std::dec;
     LOG_DEBUG(oss.str());
 
-    if (magic_int == 0x55aa1234) {
+    if (magic_int == vpk::SIGNATURE) {
         Logger::instance().info("VPK Parser: Detected VPK v2 archive format");
         return true;
     }
 
-    if (magic_int == 0x465456) {
+    if (magic_int == vpk::DIR_FORMAT_SIGNATURE) {
         Logger::instance().info("VPK Parser: Detected VPK directory format");
         return true;
     }
@@ -42,86 +57,419 @@ bool VpkParser::detect(const fs::path& archive_path) {
     return false;
 }
 
-std::string VpkParser::read_cstring(std::ifstream& file) {
-    std::string result;
-    char ch = '\0';
-    const size_t MAX_STRING_LEN = 256;
+namespace {
+
+constexpr size_t MAX_STRING_LEN = vpk::MAX_NAME_LENGTH + 1;
+constexpr size_t MD5_READ_BLOCK = 256 * 1024;
+
+struct ArchiveMd5Entry {
+    uint32_t archive_index;
+    uint32_t offset;
+    uint32_t length;
+    Md5Digest expected;
+};
+
+// Batch extraction reads across holes up to this size rather than issuing a new request,
+// and caps a single coalesced request so its buffers stay bounded
+constexpr uint64_t MAX_COALESCE_GAP = 64 * 1024;
+constexpr uint64_t MAX_COALESCED_SPAN = 8 * 1024 * 1024;
+
+struct PendingRead {
+    size_t index;
+    uint64_t offset;
+    uint32_t length;
+};
+
+// Coalesced reads of one volume: reads[read_begin, read_end) cover [start, end)
+struct ReadRun {
+    std::shared_ptr<const RandomAccessFile> handle;
+    const std::vector<PendingRead>* reads;
+    size_t read_begin;
+    size_t read_end;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Runs submitted together to the async reader, bounded in count and buffered bytes
+constexpr uint32_t ASYNC_QUEUE_DEPTH = 256;
+constexpr uint64_t MAX_WINDOW_BYTES = 64 * 1024 * 1024;
+constexpr size_t MAX_OVERFLOW_SKIP = 1000;
+
+// Position inside a mapped archive. All reads are bounds-checked against `size`.
+struct TreeCursor {
+    const uint8_t* data;
+    uint64_t size;
+    uint64_t pos;
+};
+
+enum class CStringStatus {
+    OK,
+    END_OF_FILE,
+    OVERFLOW
+};
+
+// Returns a view of the NUL-terminated string at the cursor. The terminator is located with
+// memchr, which every CRT we build against implements with vector instructions.
+CStringStatus read_cstring(TreeCursor& cursor, std::string_view& out) {
+    out = std::string_view();
+
+    if (cursor.pos >= cursor.size) {
+        std::cerr << "[ERROR] VPK: Unexpected end of file while reading string at offset "
+                                          << cursor.pos << std::endl;
+        return CStringStatus::END_OF_FILE;
+    }
+
+    const uint8_t* start = cursor.data + cursor.pos;
+    uint64_t remaining = cursor.size - cursor.pos;
+    size_t window = static_cast<size_t>(std::min<uint64_t>(remaining, MAX_STRING_LEN));
+
+    const void* terminator = std::memchr(start, '\0', window);
+    if (terminator) {
+        size_t length = static_cast<size_t>(static_cast<const uint8_t*>(terminator) - start);
+        out = std::string_view(reinterpret_cast<const char*>(start), length);
+        cursor.pos += length + 1;
+        return CStringStatus::OK;
+    }
+
+    if (remaining <= MAX_STRING_LEN) {
+        std::cerr << "[ERROR] VPK: Unexpected end of file while reading string at offset "
+                                          << cursor.size << std::endl;
+        cursor.pos = cursor.size;
+        return CStringStatus::END_OF_FILE;
+    }
+
+    std::cerr << "[ERROR] VPK: String exceeded max length (" << MAX_STRING_LEN
+                              << " chars) at offset " << (cursor.pos + MAX_STRING_LEN - 1) << std::endl;
 
-    while (result.length() < MAX_STRING_LEN) {
-        if (!file.get(ch)) {
-            std::cerr << "[ERROR] VPK: Unexpected end of file while reading string at offset "
-                                              << file.tellg() << std::endl;
-            return "\x01[READ_ERROR]\x01";
+    size_t skip_window = static_cast<size_t>(std::min<uint64_t>(remaining - MAX_STRING_LEN, MAX_OVERFLOW_SKIP + 1));
+    const void* skip_terminator = std::memchr(start + MAX_STRING_LEN, '\0', skip_window);
+    if (!skip_terminator) {
+        if (remaining - MAX_STRING_LEN <= MAX_OVERFLOW_SKIP) {
+            std::cerr << "[ERROR] VPK: End of file while skipping overflow string" << std::endl;
+            cursor.pos = cursor.size;
+            return CStringStatus::END_OF_FILE;
         }
+        std::cerr << "[ERROR] VPK: Could not find null terminator after " << MAX_OVERFLOW_SKIP
+                                          << " characters" << std::endl;
+        cursor.pos += MAX_STRING_LEN + MAX_OVERFLOW_SKIP;
+        return CStringStatus::OVERFLOW;
+    }
 
-        if (ch == '\0') {
-            break;
+    cursor.pos = static_cast<uint64_t>(static_cast<const uint8_t*>(skip_terminator) - cursor.data) + 1;
+    return CStringStatus::OVERFLOW;
+}
+
+template <typename T>
+bool read_value(TreeCursor& cursor, T& value) {
+    if (cursor.pos + sizeof(T) > cursor.size) {
+        cursor.pos = cursor.size;
+        return false;
+    }
+    std::memcpy(&value, cursor.data + cursor.pos, sizeof(T));
+    cursor.pos += sizeof(T);
+    return true;
+}
+
+std::string to_lower_ascii(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return text;
+}
+
+bool is_printable(std::string_view text) {
+    for (char c : text) {
+        if (static_cast<unsigned char>(c) < 32 || static_cast<unsigned char>(c) > 126) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Recovery scan for directory-format files whose header does not give a usable tree size.
+// A tree starts with a short extension and a directory name, each printable and NUL-terminated,
+// so most positions can be rejected from byte classes alone. The file is classified in chunks
+// into two bitmaps, 16 bytes per step where SSE2 is available; only positions that pass the
+// bitmap test are parsed as tree strings.
+constexpr uint64_t TREE_SCAN_CHUNK = 64 * 1024;
+constexpr size_t TREE_SCAN_MAX_EXTENSION = 20;
+// Longest prefix a candidate can need: extension, directory and file name with terminators
+constexpr size_t TREE_SCAN_LOOKAHEAD = TREE_SCAN_MAX_EXTENSION + 1 + 2 * MAX_STRING_LEN;
+
+struct ByteClasses {
+    // Bit i describes byte i of the classified window
+    std::vector<uint64_t> printable;
+    std::vector<uint64_t> terminator;
+};
+
+inline void set_bits(std::vector<uint64_t>& bits, size_t pos, uint32_t mask16) {
+    bits[pos / 64] |= static_cast<uint64_t>(mask16) << (pos % 64);
+}
+
+void classify_bytes(const uint8_t* data, size_t length, ByteClasses& classes) {
+    size_t words = (length + 63) / 64;
+    classes.printable.assign(words, 0);
+    classes.terminator.assign(words, 0);
+
+    size_t pos = 0;
+#ifdef UNPAKER_TREE_SCAN_SSE2
+    // SSE2 only compares signed bytes; flipping the sign bit maps 32..126 onto -96..-2
+    const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i below = _mm_set1_epi8(static_cast<char>(31 ^ 0x80));
+    const __m128i above = _mm_set1_epi8(static_cast<char>(127 ^ 0x80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 16 <= length; pos += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i flipped = _mm_xor_si128(bytes, sign);
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(flipped, below), _mm_cmplt_epi8(flipped, above));
+        set_bits(classes.printable, pos, static_cast<uint32_t>(_mm_movemask_epi8(printable)));
+        set_bits(classes.terminator, pos, static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero))));
+    }
+#endif
+    for (; pos < length; ++pos) {
+        uint8_t c = data[pos];
+        if (c >= 32 && c <= 126) {
+            set_bits(classes.printable, pos, 1);
+        } else if (c == 0) {
+            set_bits(classes.terminator, pos, 1);
         }
+    }
+}
+
+inline bool test_bit(const std::vector<uint64_t>& bits, size_t pos) {
+    return (bits[pos / 64] >> (pos % 64)) & 1;
+}
 
-        result += ch;
+inline size_t count_trailing_zeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+}
+
+// First position in [from, limit) that is not printable, or limit
+size_t find_unprintable(const ByteClasses& classes, size_t from, size_t limit) {
+    while (from < limit) {
+        uint64_t word = ~classes.printable[from / 64] >> (from % 64);
+        if (word != 0) {
+            return std::min(limit, from + count_trailing_zeros(word));
+        }
+        from = (from / 64 + 1) * 64;
     }
+    return limit;
+}
 
-    if (result.length() >= MAX_STRING_LEN && ch != '\0') {
-        std::cerr << "[ERROR] VPK: String exceeded max length (" << MAX_STRING_LEN
-                                  << " chars) at offset " << (file.tellg() - static_cast<std::streamoff>(1)) << std::endl;
-        size_t skip_count = 0;
-        const size_t MAX_SKIP = 1000;
-        while (skip_count < MAX_SKIP) {
-            if (!file.get(ch)) {
-                std::cerr << "[ERROR] VPK: End of file while skipping overflow string" << std::endl;
-                return "\x01[OVERFLOW_EOF]\x01";
-            }
-            if (ch == '\0') {
-                break;
+// Length of the printable, NUL-terminated string at pos, or 0 if there is none of at most max_length
+size_t printable_string_length(const ByteClasses& classes, size_t pos, size_t limit, size_t max_length) {
+    if (pos >= limit || !test_bit(classes.printable, pos)) {
+        return 0;
+    }
+    size_t end = find_unprintable(classes, pos, std::min(limit, pos + max_length + 1));
+    if (end - pos > max_length || end >= limit || !test_bit(classes.terminator, end)) {
+        return 0;
+    }
+    return end - pos;
+}
+
+// Parses the tree prefix at pos: extension, directory, and one file record ending in the entry
+// terminator. Prints nothing, since most probes are expected to fail.
+bool is_tree_start(const TreeCursor& file, uint64_t pos) {
+    TreeCursor probe{file.data, file.size, pos};
+    std::string_view names[3];
+    for (std::string_view& name : names) {
+        if (probe.pos >= probe.size) return false;
+        size_t window = static_cast<size_t>(std::min<uint64_t>(probe.size - probe.pos, MAX_STRING_LEN));
+        const void* terminator = std::memchr(probe.data + probe.pos, '\0', window);
+        if (!terminator) return false;
+        name = std::string_view(reinterpret_cast<const char*>(probe.data + probe.pos),
+                                static_cast<size_t>(static_cast<const uint8_t*>(terminator) - (probe.data + probe.pos)));
+        probe.pos += name.size() + 1;
+        if (name.empty() || !is_printable(name)) return false;
+    }
+    if (names[0].size() > TREE_SCAN_MAX_EXTENSION) {
+        return false;
+    }
+
+    uint16_t terminator = 0;
+    probe.pos += vpk::DIR_ENTRY_METADATA_SIZE - sizeof(uint16_t);
+    return read_value(probe, terminator) && terminator == vpk::ENTRY_TERMINATOR;
+}
+
+// Returns the first 4-byte aligned position in [begin, end) where a tree starts, or end
+uint64_t find_tree_start(const TreeCursor& file, uint64_t begin, uint64_t end) {
+    ByteClasses classes;
+    for (uint64_t chunk = begin; chunk < end; chunk += TREE_SCAN_CHUNK) {
+        uint64_t chunk_end = std::min(end, chunk + TREE_SCAN_CHUNK);
+        size_t window = static_cast<size_t>(std::min(file.size, chunk_end + TREE_SCAN_LOOKAHEAD) - chunk);
+        classify_bytes(file.data + chunk, window, classes);
+
+        for (uint64_t pos = chunk; pos < chunk_end; pos += 4) {
+            size_t local = static_cast<size_t>(pos - chunk);
+            size_t ext_length = printable_string_length(classes, local, window, TREE_SCAN_MAX_EXTENSION);
+            if (ext_length == 0) continue;
+            size_t dir = local + ext_length + 1;
+            if (printable_string_length(classes, dir, window, MAX_STRING_LEN - 1) == 0) continue;
+            if (is_tree_start(file, pos)) {
+                return pos;
             }
-            skip_count++;
-        }
-        if (skip_count >= MAX_SKIP) {
-            std::cerr << "[ERROR] VPK: Could not find null terminator after " << MAX_SKIP
-                                              << " characters" << std::endl;
-            return "\x01[OVERFLOW_NO_NULL]\x01";
         }
-        return "\x01[OVERFLOW]\x01";
     }
+    return end;
+}
+
+// Fixed-size part of a tree record. Preload bytes live in the directory file right after the
+// record; `length` counts only the bytes stored in the data volume.
+struct EntryMetadata {
+    uint32_t crc = 0;
+    uint32_t archive_index = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint32_t preload_offset = 0;
+    uint32_t preload_size = 0;
+};
+
+void add_entry(ArchiveIndexBuilder& index,
+                              std::string_view ext_name,
+                              std::string_view dir_name,
+                              std::string_view file_name,
+                              const EntryMetadata& metadata) {
+    EntryRecord record;
+    record.offset = metadata.offset;
+    record.size = metadata.preload_size + metadata.length;
+    record.crc = metadata.crc;
+    record.preload_offset = metadata.preload_offset;
+    record.preload_size = metadata.preload_size;
+    record.archive_index = static_cast<uint16_t>(metadata.archive_index);
+
+    // A single space is the tree's name for the archive root and for "no extension"
+    if (dir_name == vpk::EMPTY_NAME) {
+        dir_name = std::string_view();
+    }
+    if (ext_name == vpk::EMPTY_NAME) {
+        ext_name = std::string_view();
+    }
+    index.add(dir_name, file_name, ext_name, record);
+}
+
+void log_parse_rate(const char* format_name, uint32_t entries,
+                                        std::chrono::steady_clock::time_point started) {
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    double rate = elapsed_ms > 0.0 ? entries / (elapsed_ms / 1000.0) : 0.0;
+
+    std::ostringstream oss;
+    oss << "VPK: Parsed " << entries << " file entries from " << format_name << " in "
+        << std::fixed << std::setprecision(2) << elapsed_ms << " ms ("
+        << std::setprecision(0) << rate << " entries/sec)";
+    Logger::instance().info(oss.str());
+}
+
+constexpr uint32_t PARALLEL_DECODE_THRESHOLD = 8192;
+
+// One extension/directory block of the tree: the file records between a directory name and
+// the empty string that closes it. Records in [begin, end) are known to be well-formed.
+struct TreeBlock {
+    std::string_view ext_name;
+    std::string_view dir_name;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint32_t records = 0;
+};
+
+// A decoded record, still pointing into the mapped directory file
+struct DecodedEntry {
+    uint32_t block = 0;
+    std::string_view file_name;
+    EntryMetadata metadata;
+};
+
+void decode_v2_block(const uint8_t* data, uint64_t size, const std::vector<TreeBlock>& blocks, size_t block_index,
+                                       std::vector<DecodedEntry>& out) {
+    const TreeBlock& block = blocks[block_index];
+    TreeCursor cursor{data, size, block.begin};
+
+    while (cursor.pos < block.end) {
+        std::string_view file_name;
+        read_cstring(cursor, file_name);
+
+        EntryMetadata metadata;
+        uint16_t preload_bytes = 0;
+        uint16_t archive_index = 0;
+        read_value(cursor, metadata.crc);
+        read_value(cursor, preload_bytes);
+        read_value(cursor, archive_index);
+        read_value(cursor, metadata.offset);
+        read_value(cursor, metadata.length);
+        cursor.pos += sizeof(uint16_t); // terminator, validated in the boundary pass
+
+        metadata.archive_index = archive_index;
+        metadata.preload_offset = static_cast<uint32_t>(cursor.pos);
+        metadata.preload_size = preload_bytes;
+        cursor.pos += preload_bytes;
+
+        if (block.ext_name.length() > vpk::MAX_EXTENSION_LENGTH || block.dir_name.length() > vpk::MAX_NAME_LENGTH ||
+            file_name.length() > vpk::MAX_NAME_LENGTH) {
+            std::cerr << "[WARNING] VPK: Skipping entry with suspiciously long names: "
+                                                     << "ext=" << block.ext_name.length()
+                                                     << ", dir=" << block.dir_name.length()
+                                                     << ", file=" << file_name.length() << std::endl;
+            continue;
+        }
+
+        if (!is_printable(block.ext_name) || !is_printable(block.dir_name) || !is_printable(file_name)) {
+            std::cerr << "[WARNING] VPK: Skipping entry with invalid characters (file: "
+                                                      << file_name << ")" << std::endl;
+            continue;
+        }
 
-    return result;
+        out.push_back(DecodedEntry{static_cast<uint32_t>(block_index), file_name, metadata});
+    }
 }
 
-bool VpkParser::parse_vpk_v2(std::ifstream& file,
-                                                         std::shared_ptr<DirectoryEntry>& root,
+} // namespace
+
+bool VpkParser::parse_vpk_v2(const MappedFile& mapping,
+                                                         ArchiveIndexBuilder& index,
                                                          uint32_t& file_count) {
     Logger::instance().info("VPK: Parsing v2 archive format");
 
-    file.seekg(0, std::ios::end);
-    uint64_t file_size = file.tellg();
-    file.seekg(4); // Skip signature
+    uint64_t file_size = mapping.size();
+    TreeCursor cursor{mapping.data(), file_size, 4}; // Skip signature
 
     uint32_t version = 0;
-    file.read(reinterpret_cast<char*>(&version), 4);
+    read_value(cursor, version);
 
     uint32_t tree_size = 0;
-    file.read(reinterpret_cast<char*>(&tree_size), 4);
+    read_value(cursor, tree_size);
 
     Logger::instance().info(std::string("VPK: Version=") + std::to_string(version) + std::string(", TreeSize=") + std::to_string(tree_size));
 
-    uint32_t tree_offset = 12;
+    uint32_t tree_offset = vpk::V1_HEADER_SIZE;
     if (version == 2) {
         uint32_t file_data_section_size = 0;
-        file.read(reinterpret_cast<char*>(&file_data_section_size), 4);
+        read_value(cursor, file_data_section_size);
 
-        uint32_t tree_crc = 0, file_crc = 0, meta_crc = 0;
-        file.read(reinterpret_cast<char*>(&tree_crc), 4);
-        file.read(reinterpret_cast<char*>(&file_crc), 4);
-        file.read(reinterpret_cast<char*>(&meta_crc), 4);
+        uint32_t archive_md5_section_size = 0, other_md5_section_size = 0, signature_section_size = 0;
+        read_value(cursor, archive_md5_section_size);
+        read_value(cursor, other_md5_section_size);
+        read_value(cursor, signature_section_size);
 
-        tree_offset = 28;
+        tree_offset = vpk::V2_HEADER_SIZE;
         std::cout << "[INFO] VPK: FileDataSectionSize=" << file_data_section_size
-                                  << ", TreeCRC=0x" << std::hex << tree_crc
-                                  << ", FileCRC=0x" << file_crc
-                                  << ", MetaCRC=0x" << meta_crc << std::dec << std::endl;
+                                  << ", ArchiveMD5SectionSize=" << archive_md5_section_size
+                                  << ", OtherMD5SectionSize=" << other_md5_section_size
+                                  << ", SignatureSectionSize=" << signature_section_size << std::endl;
+    }
+
+    if (file_size < tree_offset) {
+        std::cerr << "[ERROR] VPK: File too small for v" << version << " header" << std::endl;
+        return false;
     }
 
-    file.seekg(tree_offset);
+    cursor.pos = tree_offset;
 
     if (tree_size > static_cast<uint32_t>(file_size - tree_offset)) {
         std::cerr << "[WARNING] VPK: tree_size (" << tree_size
@@ -130,49 +478,50 @@ bool VpkParser::parse_vpk_v2(std::ifstream& file,
         tree_size = static_cast<uint32_t>(file_size - tree_offset);
     }
 
-    std::streampos tree_end_pos = tree_offset + tree_size;
+    const uint64_t tree_end_pos = static_cast<uint64_t>(tree_offset) + tree_size;
 
     DEBUG_COUT("[DEBUG] VPK: Tree starts at offset " << tree_offset
                               << ", tree_size=" << tree_size << ", tree should end at offset " << tree_end_pos
                               << ", file size=" << file_size << std::endl);
 
-    uint32_t file_count_local = 0;
+    auto started = std::chrono::steady_clock::now();
 
-    auto is_error_marker = [](const std::string& s) {
-        return s.find("[OVERFLOW]") != std::string::npos || s.find("[ERROR") != std::string::npos;
-    };
+    // Pass 1: walk the tree structure only, recording where each directory block's records live.
+    std::vector<TreeBlock> blocks;
+    uint64_t total_records = 0;
 
-    while (file.tellg() < tree_end_pos && file.good()) {
-        std::string ext_name = read_cstring(file);
+    while (cursor.pos < tree_end_pos) {
+        std::string_view ext_name;
+        CStringStatus status = read_cstring(cursor, ext_name);
 
-        if (file.tellg() > tree_end_pos) break;
+        if (status == CStringStatus::END_OF_FILE || cursor.pos > tree_end_pos) break;
 
-        if (is_error_marker(ext_name)) {
+        if (status == CStringStatus::OVERFLOW) {
             std::cerr << "[ERROR] VPK: Found error marker in extension name, stopping parse" << std::endl;
             break;
         }
 
         if (ext_name.empty()) {
             uint16_t term_check = 0;
-            std::streampos current = file.tellg();
-            if (current + static_cast<std::streamoff>(2) > tree_end_pos) break;
-            file.read(reinterpret_cast<char*>(&term_check), 2);
-            if (term_check == 0xffff) {
+            if (cursor.pos + 2 > tree_end_pos) break;
+            read_value(cursor, term_check);
+            if (term_check == vpk::ENTRY_TERMINATOR) {
                 DEBUG_COUT("[DEBUG] VPK: Tree parsing completed successfully" << std::endl);
                 break;
             }
-            file.seekg(-2, std::ios_base::cur);
+            cursor.pos -= 2;
             continue;
         }
 
         DEBUG_COUT("[DEBUG] VPK: Extension: " << ext_name << std::endl);
 
-        while (file.tellg() < tree_end_pos && file.good()) {
-            std::string dir_name = read_cstring(file);
+        while (cursor.pos < tree_end_pos) {
+            std::string_view dir_name;
+            status = read_cstring(cursor, dir_name);
 
-            if (file.tellg() > tree_end_pos) break;
+            if (status == CStringStatus::END_OF_FILE || cursor.pos > tree_end_pos) break;
 
-            if (is_error_marker(dir_name)) {
+            if (status == CStringStatus::OVERFLOW) {
                 std::cerr << "[ERROR] VPK: Found error marker in directory name, aborting extension" << std::endl;
                 break;
             }
@@ -181,24 +530,26 @@ bool VpkParser::parse_vpk_v2(std::ifstream& file,
                 break;
             }
 
-            while (file.tellg() < tree_end_pos && file.good()) {
-                std::streampos before_read = file.tellg();
+            TreeBlock block;
+            block.ext_name = ext_name;
+            block.dir_name = dir_name;
+            block.begin = cursor.pos;
 
-                std::string file_name = read_cstring(file);
-                std::streampos after_read = file.tellg();
+            while (cursor.pos < tree_end_pos) {
+                uint64_t before_read = cursor.pos;
+                block.end = before_read;
 
-                if (after_read <= before_read && !file_name.empty()) {
-                    std::cerr << "[ERROR] VPK: File position did not advance after reading file name at offset "
-                                                              << before_read << std::endl;
-                    break;
-                }
+                std::string_view file_name;
+                status = read_cstring(cursor, file_name);
+
+                if (status == CStringStatus::END_OF_FILE) break;
 
-                if (file.tellg() > tree_end_pos) {
-                    std::cerr << "[WARNING] VPK: Read past tree boundary at offset " << file.tellg() << std::endl;
+                if (cursor.pos > tree_end_pos) {
+                    std::cerr << "[WARNING] VPK: Read past tree boundary at offset " << cursor.pos << std::endl;
                     break;
                 }
 
-                if (is_error_marker(file_name)) {
+                if (status == CStringStatus::OVERFLOW) {
                     std::cerr << "[ERROR] VPK: Found error marker in file name, aborting directory" << std::endl;
                     break;
                 }
@@ -207,289 +558,142 @@ bool VpkParser::parse_vpk_v2(std::ifstream& file,
                     break;
                 }
 
-                if (file_name.length() > 0 && (file_name[0] == '+' || file_name[0] == '{' || file_name[0] == '~')) {
-                    DEBUG_CERR("[DEBUG] VPK: Reading suspicious file name \"" << file_name
-                                                              << "\" at offset " << before_read
-                                                              << ", after read at " << after_read
-                                                              << ", bytes read: " << (after_read - before_read)
-                                                              << ", expected: " << (file_name.length() + 1) << std::endl);
-
-                    std::streamoff expected_offset = before_read + static_cast<std::streamoff>(file_name.length() + 1);
-                    if (after_read != expected_offset) {
-                        std::cerr << "[ERROR] VPK: Position mismatch! Expected " << expected_offset
-                                                                  << " but got " << after_read
-                                                                  << " (difference: " << (after_read - expected_offset) << " bytes)" << std::endl;
-                        std::cerr << "[ERROR] VPK: This indicates the string was not read correctly - "
-                                                                  << "possibly missing or extra null terminator" << std::endl;
-                        std::streampos saved_pos = file.tellg();
-                        char check_bytes[20];
-                        file.read(check_bytes, 20);
-                        file.seekg(saved_pos);
-                        DEBUG_CERR("[DEBUG] VPK: Bytes at current position (hex): ");
-                        #ifdef _DEBUG
-                        for (int i = 0; i < 20; i++) {
-                            std::cerr << std::hex << std::setw(2) << std::setfill('0')
-                                                                              << (unsigned char)check_bytes[i] << " ";
-                        }
-                        std::cerr << std::dec << std::endl;
-                        #endif
-
-                        file.seekg(expected_offset);
-                    }
-                }
-
-                std::streampos current_pos = file.tellg();
-                if (current_pos + static_cast<std::streamoff>(18) > tree_end_pos) {
+                if (cursor.pos + vpk::ENTRY_METADATA_SIZE > tree_end_pos) {
                     std::cerr << "[WARNING] VPK: Not enough space for file metadata at "
-                                                              << current_pos << " (need 18 bytes, have "
-                                                              << (tree_end_pos - current_pos) << "), stopping parse" << std::endl;
-                    file.seekg(tree_end_pos);
-                    break;
-                }
-
-                std::streampos before_metadata = file.tellg();
-
-                uint32_t crc = 0;
-                uint32_t archive_index = 0;
-                uint32_t entry_offset = 0;
-                uint32_t entry_size = 0;
-
-                if (!file.read(reinterpret_cast<char*>(&crc), 4)) {
-                    std::cerr << "[ERROR] VPK: Failed to read CRC at offset " << file.tellg() << std::endl;
-                    break;
-                }
-                if (!file.read(reinterpret_cast<char*>(&archive_index), 4)) {
-                    std::cerr << "[ERROR] VPK: Failed to read archive_index at offset " << file.tellg() << std::endl;
-                    break;
-                }
-                if (!file.read(reinterpret_cast<char*>(&entry_offset), 4)) {
-                    std::cerr << "[ERROR] VPK: Failed to read entry_offset at offset " << file.tellg() << std::endl;
-                    break;
-                }
-                if (!file.read(reinterpret_cast<char*>(&entry_size), 4)) {
-                    std::cerr << "[ERROR] VPK: Failed to read entry_size at offset " << file.tellg() << std::endl;
+                                                              << cursor.pos << " (need 18 bytes, have "
+                                                              << (tree_end_pos - cursor.pos) << "), stopping parse" << std::endl;
+                    cursor.pos = tree_end_pos;
                     break;
                 }
 
+                uint16_t preload_bytes = 0;
                 uint16_t term_flag = 0;
-                if (!file.read(reinterpret_cast<char*>(&term_flag), 2)) {
-                    std::cerr << "[ERROR] VPK: Failed to read terminator flag at offset " << file.tellg() << std::endl;
+                std::memcpy(&preload_bytes, cursor.data + cursor.pos + 4, sizeof(preload_bytes));
+                std::memcpy(&term_flag, cursor.data + cursor.pos + vpk::ENTRY_METADATA_SIZE - 2, sizeof(term_flag));
+                cursor.pos += vpk::ENTRY_METADATA_SIZE;
+
+                if (term_flag != vpk::ENTRY_TERMINATOR) {
+                    std::cerr << "[ERROR] VPK: Invalid terminator 0x" << std::hex << term_flag
+                                                              << std::dec << " expected 0xffff at offset " << (cursor.pos - 2)
+                                                              << " (entry at offset " << before_read
+                                                              << ", file: " << file_name << ")" << std::endl;
                     break;
                 }
 
-                std::streampos after_metadata = file.tellg();
-
-                std::streamoff metadata_bytes_read = after_metadata - before_metadata;
-                if (metadata_bytes_read != 18) {
-                    std::cerr << "[ERROR] VPK: Metadata read error! Expected 18 bytes, but read "
-                                                              << metadata_bytes_read << " bytes at offset " << before_metadata << std::endl;
+                if (cursor.pos + preload_bytes > tree_end_pos) {
+                    std::cerr << "[WARNING] VPK: Preload data of " << preload_bytes << " bytes at offset "
+                                                              << cursor.pos << " runs past the tree, stopping parse" << std::endl;
+                    cursor.pos = tree_end_pos;
                     break;
                 }
+                cursor.pos += preload_bytes;
 
-                if (term_flag == 0xffff) {
-                    std::streampos current_file_pos = before_read;
-
-
-                    if (ext_name.length() > 50 || dir_name.length() > 256 || file_name.length() > 256) {
-                        std::cerr << "[WARNING] VPK: Skipping entry with suspiciously long names: "
-                                                                 << "ext=" << ext_name.length()
-                                                                 << ", dir=" << dir_name.length()
-                                                                 << ", file=" << file_name.length() << std::endl;
-                        continue;
-                    }
-
-                    bool valid = true;
-                    for (char c : ext_name) {
-                        if (static_cast<unsigned char>(c) < 32 || c > 126) { valid = false; break; }
-                    }
-                    for (char c : dir_name) {
-                        if (static_cast<unsigned char>(c) < 32 || c > 126) { valid = false; break; }
-                    }
-                    for (char c : file_name) {
-                        if (static_cast<unsigned char>(c) < 32 || c > 126) { valid = false; break; }
-                    }
-
-                    if (!valid) {
-                        std::cerr << "[WARNING] VPK: Skipping entry with invalid characters (file: "
-                                                                  << file_name << ")" << std::endl;
-                        continue;
-                    }
-
-                    auto entry = std::make_shared<FileEntry>();
-                    if (!entry) {
-                        std::cerr << "[ERROR] VPK: Memory allocation failed" << std::endl;
-                        return false;
-                    }
-
-                    entry->name.reserve(file_name.length() + ext_name.length() + 1);
-                    entry->name = file_name;
-                    entry->name += '.';
-                    entry->name += ext_name;
-
-                    entry->offset = entry_offset;
-                    entry->size = entry_size;
-                    entry->archive_index = archive_index;
-
-                    if (dir_name != " " && !dir_name.empty()) {
-                        entry->path.reserve(dir_name.length() + file_name.length() + ext_name.length() + 2);
-                        entry->path = dir_name;
-                        entry->path += '/';
-                        entry->path += file_name;
-                        entry->path += '.';
-                        entry->path += ext_name;
-                    } else {
-                        entry->path.reserve(file_name.length() + ext_name.length() + 1);
-                        entry->path = file_name;
-                        entry->path += '.';
-                        entry->path += ext_name;
-                    }
-
-                    entry->is_directory = false;
+                block.end = cursor.pos;
+                block.records++;
+            }
 
-                    if (!entry->name.empty() && !entry->path.empty()) {
-                        root->files.push_back(entry);
-                        file_count++;
-                        file_count_local++;
-                    }
-                } else {
-                    std::streampos err_pos = file.tellg();
-                    std::cerr << "[ERROR] VPK: Invalid terminator 0x" << std::hex << term_flag
-                                                              << std::dec << " expected 0xffff at offset " << (err_pos - static_cast<std::streamoff>(2))
-                                                              << " (file: " << file_name << ")" << std::endl;
-                    break;
-                }
+            if (block.records > 0) {
+                total_records += block.records;
+                blocks.push_back(block);
             }
         }
     }
 
-    Logger::instance().info(std::string("VPK: Parsed ") + std::to_string(file_count_local) + std::string(" file entries from v2 archive"));
-
-    build_directory_structure(root);
-
-    return file_count_local > 0;
-}
-
-void VpkParser::build_directory_structure(std::shared_ptr<DirectoryEntry>& root) {
-    if (!root || root->files.empty()) return;
+    // Pass 2: decode blocks into per-chunk record vectors, then add them to the index in tree
+    // order so the result does not depend on scheduling.
+    std::vector<std::vector<DecodedEntry>> decoded;
+    size_t threads = ThreadPool::resolve_thread_count(thread_count);
 
-    std::ostringstream oss_build;
-    oss_build << "VPK: Building directory hierarchy from " << root->files.size() << " files";
-    LOG_DEBUG(oss_build.str());
-
-    std::map<std::string, std::shared_ptr<DirectoryEntry>> dir_map;
-    dir_map[""] = root;
-
-    struct FileMoveInfo {
-        std::shared_ptr<FileEntry> file;
-        std::shared_ptr<DirectoryEntry> target_dir;
-    };
-    std::vector<FileMoveInfo> files_to_move;
-
-    for (const auto& file : root->files) {
-        if (!file) continue;
-
-        size_t last_slash = file->path.find_last_of("/\\");
-        if (last_slash != std::string::npos) {
-            std::string dir_path = file->path.substr(0, last_slash);
-            std::string file_name_with_ext = file->path.substr(last_slash + 1);
-
-            std::string current_path;
-            std::shared_ptr<DirectoryEntry> current_parent = root;
-
-            size_t pos = 0;
-            while (pos < dir_path.length()) {
-                size_t next_slash = dir_path.find('/', pos);
-                if (next_slash == std::string::npos) {
-                    next_slash = dir_path.length();
+    try {
+        if (threads <= 1 || total_records < PARALLEL_DECODE_THRESHOLD) {
+            decoded.resize(1);
+            decoded[0].reserve(static_cast<size_t>(total_records));
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                decode_v2_block(mapping.data(), file_size, blocks, i, decoded[0]);
+            }
+        } else {
+            uint64_t chunk_target = std::max<uint64_t>(total_records / (threads * 8), 1024);
+            std::vector<std::pair<size_t, size_t>> chunks;
+            size_t chunk_begin = 0;
+            uint64_t chunk_records = 0;
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                chunk_records += blocks[i].records;
+                if (chunk_records >= chunk_target || i + 1 == blocks.size()) {
+                    chunks.emplace_back(chunk_begin, i + 1);
+                    chunk_begin = i + 1;
+                    chunk_records = 0;
                 }
+            }
 
-                std::string dir_name = dir_path.substr(pos, next_slash - pos);
-                if (!dir_name.empty() && dir_name != ".") {
-                    if (current_path.empty()) {
-                        current_path = dir_name;
-                    } else {
-                        current_path += '/';
-                        current_path += dir_name;
-                    }
-
-                    if (dir_map.find(current_path) == dir_map.end()) {
-                        auto new_dir = std::make_shared<DirectoryEntry>();
-                        if (!new_dir) {
-                            std::cerr << "[ERROR] VPK: Memory allocation failed for directory" << std::endl;
-                            return;
-                        }
-                        new_dir->name = dir_name;
-                        new_dir->is_directory = true;
-                        new_dir->parent = current_parent;
-
-                        current_parent->subdirectories.push_back(new_dir);
-                        dir_map[current_path] = new_dir;
-                    }
-
-                    current_parent = dir_map[current_path];
+            decoded.resize(chunks.size());
+            auto decode_chunk = [&](size_t chunk) {
+                auto& out = decoded[chunk];
+                for (size_t i = chunks[chunk].first; i < chunks[chunk].second; ++i) {
+                    decode_v2_block(mapping.data(), file_size, blocks, i, out);
                 }
+            };
 
-                pos = next_slash + 1;
-            }
+            ThreadPool::run(chunks.size(), threads, decode_chunk);
 
-            file->name = file_name_with_ext;
-            FileMoveInfo move_info;
-            move_info.file = file;
-            move_info.target_dir = current_parent;
-            files_to_move.push_back(move_info);
-        } else {
+            DEBUG_COUT("[DEBUG] VPK: Decoded " << blocks.size() << " directory blocks in "
+                                               << chunks.size() << " chunks on " << threads << " threads" << std::endl);
         }
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[ERROR] VPK: Memory allocation failed" << std::endl;
+        return false;
     }
 
-    for (const auto& move_info : files_to_move) {
-        if (move_info.file && move_info.target_dir) {
-            move_info.target_dir->files.push_back(move_info.file);
+    uint32_t file_count_local = 0;
+    size_t decoded_total = 0;
+    for (const auto& chunk : decoded) {
+        decoded_total += chunk.size();
+    }
+
+    try {
+        index.reserve(index.size() + decoded_total);
+        for (const auto& chunk : decoded) {
+            for (const auto& entry : chunk) {
+                const TreeBlock& block = blocks[entry.block];
+                add_entry(index, block.ext_name, block.dir_name, entry.file_name, entry.metadata);
+            }
+            file_count_local += static_cast<uint32_t>(chunk.size());
         }
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[ERROR] VPK: Memory allocation failed" << std::endl;
+        return false;
     }
+    file_count += file_count_local;
 
-    root->files.erase(
-        std::remove_if(root->files.begin(), root->files.end(),
-            [&files_to_move](const std::shared_ptr<FileEntry>& f) {
-                return std::any_of(files_to_move.begin(), files_to_move.end(),
-                    [&f](const FileMoveInfo& move_info) {
-                        return move_info.file == f;
-                    });
-            }),
-        root->files.end()
-    );
+    log_parse_rate("v2 archive", file_count_local, started);
 
-    std::ostringstream oss_dirs;
-    oss_dirs << "VPK: Created " << (dir_map.size() - 1) << " directories";
-    LOG_DEBUG(oss_dirs.str());
+    return file_count_local > 0;
 }
 
-bool VpkParser::parse_vpk_dir(std::ifstream& file,
-                                                              std::shared_ptr<DirectoryEntry>& root,
+bool VpkParser::parse_vpk_dir(const MappedFile& mapping,
+                                                              ArchiveIndexBuilder& index,
                                                               uint32_t& file_count) {
     Logger::instance().info("VPK: Parsing directory file format");
 
-    file.seekg(0, std::ios::end);
-    uint64_t file_size = file.tellg();
-
-    file.seekg(4); // Skip 0x465456 signature
+    uint64_t file_size = mapping.size();
+    TreeCursor cursor{mapping.data(), file_size, 4}; // Skip 0x465456 signature
 
     uint32_t version = 0;
-    file.read(reinterpret_cast<char*>(&version), 4);
+    read_value(cursor, version);
 
     uint32_t tree_crc = 0;
-    file.read(reinterpret_cast<char*>(&tree_crc), 4);
+    read_value(cursor, tree_crc);
 
     uint32_t tree_size = 0;
-    file.read(reinterpret_cast<char*>(&tree_size), 4);
+    read_value(cursor, tree_size);
 
     uint32_t file_crc = 0;
-    file.read(reinterpret_cast<char*>(&file_crc), 4);
+    read_value(cursor, file_crc);
 
     uint32_t meta_crc = 0;
-    file.read(reinterpret_cast<char*>(&meta_crc), 4);
+    read_value(cursor, meta_crc);
 
     uint32_t content_crc = 0;
-    file.read(reinterpret_cast<char*>(&content_crc), 4);
+    read_value(cursor, content_crc);
 
     std::cout << "[INFO] VPK: Dir Version=" << version << ", TreeCRC=0x" << std::hex << tree_crc
                               << std::dec << ", TreeSize=" << tree_size
@@ -499,54 +703,28 @@ bool VpkParser::parse_vpk_dir(std::ifstream& file,
 
     uint32_t tree_offset = 28;
 
+    if (file_size < tree_offset) {
+        std::cerr << "[ERROR] VPK: File too small for directory header" << std::endl;
+        return false;
+    }
+
     if (tree_size == 0 || tree_size > static_cast<uint32_t>(file_size - tree_offset)) {
         std::cout << "[WARNING] VPK: Invalid tree_size in header (" << tree_size
                                   << "), scanning for valid tree data..." << std::endl;
 
-        const uint64_t MAX_SCAN = 10000;
         bool found_valid_start = false;
 
-        for (uint64_t scan = 0; scan < MAX_SCAN; scan += 4) {
-            uint64_t pos = tree_offset + scan;
-            if (pos >= file_size - 100) break;
-
-            file.seekg(static_cast<std::streampos>(pos));
-
-            std::string potential_ext = read_cstring(file);
-
-            if (potential_ext.length() > 0 && potential_ext.length() <= 20) {
-                bool all_printable = true;
-                for (char c : potential_ext) {
-                    if (c < 32 || c > 126) {
-                        all_printable = false;
-                        break;
-                    }
-                }
-
-                if (all_printable) {
-                    std::string potential_dir = read_cstring(file);
-
-                    if (potential_dir.length() > 0 && potential_dir.length() <= 256) {
-                        bool dir_valid = true;
-                        for (char c : potential_dir) {
-                            if (c < 32 || c > 126) {
-                                dir_valid = false;
-                                break;
-                            }
-                        }
-
-                        if (dir_valid) {
-                            std::cout << "[INFO] VPK: Found valid tree start at offset " << pos
-                                                                         << " with extension '" << potential_ext << "'" << std::endl;
-                            tree_offset = static_cast<uint32_t>(pos);
-                            found_valid_start = true;
-                            break;
-                        }
-                    }
-                }
+        if (file_size >= 100) {
+            // Tree offsets are stored as u32
+            uint64_t scan_end = std::min<uint64_t>(file_size - 100, UINT32_MAX);
+            uint64_t start = find_tree_start(cursor, tree_offset, scan_end);
+            if (start < scan_end) {
+                const char* extension = reinterpret_cast<const char*>(mapping.data() + start);
+                std::cout << "[INFO] VPK: Found valid tree start at offset " << start
+                                                 << " with extension '" << extension << "'" << std::endl;
+                tree_offset = static_cast<uint32_t>(start);
+                found_valid_start = true;
             }
-
-            file.seekg(static_cast<std::streampos>(pos + 4));
         }
 
         if (!found_valid_start) {
@@ -557,37 +735,40 @@ bool VpkParser::parse_vpk_dir(std::ifstream& file,
         std::cout << "[INFO] VPK: Using tree_size from header: " << tree_size << " bytes" << std::endl;
     }
 
-    file.seekg(tree_offset);
+    cursor.pos = tree_offset;
 
     DEBUG_COUT("[DEBUG] VPK Dir: Starting tree parsing at offset " << tree_offset
                               << ", file size: " << file_size << std::endl);
 
-    std::streampos tree_end_pos;
+    uint64_t tree_end_pos;
     if (tree_size > 0 && tree_size < static_cast<uint32_t>(file_size)) {
-        tree_end_pos = tree_offset + tree_size;
+        tree_end_pos = static_cast<uint64_t>(tree_offset) + tree_size;
     } else {
-        tree_end_pos = file_size - 48;
+        tree_end_pos = file_size > 48 ? file_size - 48 : 0;
     }
 
+    auto started = std::chrono::steady_clock::now();
     uint32_t file_count_local = 0;
 
-    while (file.tellg() < tree_end_pos && file.good()) {
-        std::string ext_name = read_cstring(file);
+    while (cursor.pos < tree_end_pos) {
+        std::string_view ext_name;
+        if (read_cstring(cursor, ext_name) == CStringStatus::END_OF_FILE) break;
 
         if (ext_name.empty()) {
             uint16_t term_check = 0;
-            file.read(reinterpret_cast<char*>(&term_check), 2);
-            if (term_check == 0xffff) {
+            if (!read_value(cursor, term_check)) break;
+            if (term_check == vpk::ENTRY_TERMINATOR) {
                 break;
             }
-            file.seekg(-2, std::ios_base::cur);
+            cursor.pos -= 2;
             continue;
         }
 
         DEBUG_COUT("[DEBUG] VPK: Dir - Extension: " << ext_name << std::endl);
 
-        while (file.tellg() < tree_end_pos && file.good()) {
-            std::string dir_name = read_cstring(file);
+        while (cursor.pos < tree_end_pos) {
+            std::string_view dir_name;
+            if (read_cstring(cursor, dir_name) == CStringStatus::END_OF_FILE) break;
 
             if (dir_name.empty()) {
                 break;
@@ -595,34 +776,39 @@ bool VpkParser::parse_vpk_dir(std::ifstream& file,
 
             DEBUG_COUT("[DEBUG] VPK: Dir - Directory: " << dir_name << std::endl);
 
-            while (file.tellg() < tree_end_pos && file.good()) {
-                std::string file_name = read_cstring(file);
+            while (cursor.pos < tree_end_pos) {
+                std::string_view file_name;
+                if (read_cstring(cursor, file_name) == CStringStatus::END_OF_FILE) break;
 
                 if (file_name.empty()) {
                     break;
                 }
 
-                uint32_t crc_entry = 0;
-                uint32_t preload_size = 0;
-                uint32_t archive_index = 0;
-                uint32_t entry_offset = 0;
-                uint32_t entry_size = 0;
-
-                file.read(reinterpret_cast<char*>(&crc_entry), 4);
-                file.read(reinterpret_cast<char*>(&preload_size), 4);
-                file.read(reinterpret_cast<char*>(&archive_index), 4);
-                file.read(reinterpret_cast<char*>(&entry_offset), 4);
-                file.read(reinterpret_cast<char*>(&entry_size), 4);
+                EntryMetadata metadata;
+                uint16_t term_flag = 0;
 
-                if (!file.good()) {
+                if (!read_value(cursor, metadata.crc) ||
+                    !read_value(cursor, metadata.preload_size) ||
+                    !read_value(cursor, metadata.archive_index) ||
+                    !read_value(cursor, metadata.offset) ||
+                    !read_value(cursor, metadata.length)) {
                     break;
                 }
 
-                uint16_t term_flag = 0;
-                file.read(reinterpret_cast<char*>(&term_flag), 2);
+                read_value(cursor, term_flag);
 
-                if (term_flag == 0xffff) {
-                    if (ext_name.length() > 50 || dir_name.length() > 512 || file_name.length() > 512) {
+                if (term_flag == vpk::ENTRY_TERMINATOR) {
+                    if (metadata.preload_size > tree_end_pos - std::min(cursor.pos, tree_end_pos)) {
+                        std::cerr << "[WARNING] VPK: Preload data of " << metadata.preload_size
+                                                                  << " bytes at offset " << cursor.pos
+                                                                  << " runs past the tree, stopping parse" << std::endl;
+                        break;
+                    }
+                    metadata.preload_offset = static_cast<uint32_t>(cursor.pos);
+                    cursor.pos += metadata.preload_size;
+
+                    if (ext_name.length() > vpk::MAX_EXTENSION_LENGTH || dir_name.length() > vpk::MAX_NAME_LENGTH ||
+                        file_name.length() > vpk::MAX_NAME_LENGTH) {
                         std::cerr << "[WARNING] VPK: Skipping entry with suspiciously long names: "
                                                                  << "ext=" << ext_name.length()
                                                                  << ", dir=" << dir_name.length()
@@ -630,50 +816,19 @@ bool VpkParser::parse_vpk_dir(std::ifstream& file,
                         continue;
                     }
 
-                    bool valid = true;
-                    for (char c : ext_name) {
-                        if (c < 32 || c > 126) { valid = false; break; }
-                    }
-                    for (char c : dir_name) {
-                        if (c < 32 || c > 126) { valid = false; break; }
-                    }
-                    for (char c : file_name) {
-                        if (c < 32 || c > 126) { valid = false; break; }
-                    }
-
-                    if (!valid) {
+                    if (!is_printable(ext_name) || !is_printable(dir_name) || !is_printable(file_name)) {
                         std::cerr << "[WARNING] VPK: Skipping entry with invalid characters" << std::endl;
                         continue;
                     }
 
-                    auto entry = std::make_shared<FileEntry>();
-                    if (!entry) {
-                        std::cerr << "[ERROR] VPK: Memory allocation failed" << std::endl;
-                        return false;
-                    }
-
-                    entry->name = file_name + "." + ext_name;
-                    entry->offset = entry_offset;
-                    entry->size = entry_size;
-                    entry->archive_index = archive_index;
-
-                    if (dir_name != " ") {
-                        entry->path = dir_name + "/" + file_name + "." + ext_name;
-                    } else {
-                        entry->path = file_name + "." + ext_name;
-                    }
-
-                    DEBUG_COUT("[DEBUG] VPK: File=" << entry->path
-                                                         << ", ArchiveIndex=" << archive_index
-                                                         << ", Size=" << entry_size << std::endl);
+                    DEBUG_COUT("[DEBUG] VPK: File=" << dir_name << "/" << file_name << "." << ext_name
+                                                         << ", ArchiveIndex=" << metadata.archive_index
+                                                         << ", Size=" << (metadata.preload_size + metadata.length)
+                                                         << ", Preload=" << metadata.preload_size << std::endl);
 
-                    entry->is_directory = false;
-
-                    if (!entry->name.empty()) {
-                        root->files.push_back(entry);
-                        file_count++;
-                        file_count_local++;
-                    }
+                    add_entry(index, ext_name, dir_name, file_name, metadata);
+                    file_count++;
+                    file_count_local++;
                 } else {
                     break;
                 }
@@ -681,35 +836,40 @@ bool VpkParser::parse_vpk_dir(std::ifstream& file,
         }
     }
 
-    std::cout << "[INFO] VPK: Parsed " << file_count_local << " file entries from directory file" << std::endl;
+    log_parse_rate("directory file", file_count_local, started);
     return file_count_local > 0;
 }
 
 bool VpkParser::parse(const fs::path& archive_path,
-                                         std::shared_ptr<DirectoryEntry>& root,
+                                         ArchiveIndexBuilder& index,
                                          uint32_t& file_count) {
-    std::ifstream file(archive_path, std::ios::binary);
-    if (!file) {
+    auto mapping = open_directory(archive_path);
+    if (!mapping) {
         std::cerr << "[ERROR] VPK: Cannot open file: " << archive_path.string() << std::endl;
         return false;
     }
 
-    file.seekg(0, std::ios::end);
-    uint64_t file_size = file.tellg();
-    file.seekg(0);
-
-    if (file_size < 8) {
+    if (mapping->size() < 8) {
         std::cerr << "[ERROR] VPK: File too small" << std::endl;
         return false;
     }
 
     uint32_t signature = 0;
-    file.read(reinterpret_cast<char*>(&signature), 4);
+    std::memcpy(&signature, mapping->data(), sizeof(uint32_t));
+
+    if (signature == vpk::SIGNATURE || signature == vpk::DIR_FORMAT_SIGNATURE) {
+        bool parsed = signature == vpk::SIGNATURE ? parse_vpk_v2(*mapping, index, file_count)
+                                               : parse_vpk_dir(*mapping, index, file_count);
 
-    if (signature == 0x55aa1234) {
-        return parse_vpk_v2(file, root, file_count);
-    } else if (signature == 0x465456) {
-        return parse_vpk_dir(file, root, file_count);
+        // Keep the directory file open: preload bytes are served straight from it. Data volumes
+        // are located once here instead of per extracted entry.
+        auto table = discover_volumes(archive_path, mapping.get());
+
+        std::lock_guard<std::mutex> lock(mapping_mutex);
+        directory_mapping = mapping;
+        directory_mapping_path = archive_path;
+        volume_table = table;
+        return parsed;
     } else {
         std::string filename = archive_path.filename().string();
         if (filename.find("_0") != std::string::npos ||
@@ -735,182 +895,702 @@ bool VpkParser::extract_file(const fs::path& archive_path,
     }
 
     try {
-        fs::path data_file_path = archive_path;
+        data.resize(file->size);
+        size_t bytes_read = 0;
+        bool success = extract_into(archive_path, file, data.data(), data.size(), bytes_read);
+        data.resize(bytes_read);
+        return success;
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] VPK: Exception in extract_file: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        if (file->archive_index == 0x7fff) {
-            data_file_path = archive_path;
-        } else {
-            std::string dir_path = archive_path.string();
-            std::string base_path = dir_path;
-
-            size_t dir_pos = base_path.find("_dir.vpk");
-            if (dir_pos != std::string::npos) {
-                std::string archive_suffix = "_";
-                if (file->archive_index < 10) {
-                    archive_suffix += "00" + std::to_string(file->archive_index);
-                } else if (file->archive_index < 100) {
-                    archive_suffix += "0" + std::to_string(file->archive_index);
-                } else {
-                    archive_suffix += std::to_string(file->archive_index);
-                }
-                archive_suffix += ".vpk";
-                base_path.replace(dir_pos, 8, archive_suffix);
-                data_file_path = fs::path(base_path);
-            } else {
-                std::string stem = archive_path.stem().string();
-                size_t dir_suffix_pos = stem.find("_dir");
-                if (dir_suffix_pos != std::string::npos) {
-                    stem.replace(dir_suffix_pos, 4, "");
-                }
+bool VpkParser::extract_into(const fs::path& archive_path,
+                             const std::shared_ptr<FileEntry>& file,
+                             uint8_t* buffer,
+                             size_t capacity,
+                             size_t& bytes_read) const {
+    bytes_read = 0;
+    if (!file) {
+        std::cerr << "[ERROR] VPK: Invalid file entry" << std::endl;
+        return false;
+    }
+    if (capacity < file->size) {
+        std::cerr << "[ERROR] VPK: Buffer of " << capacity << " bytes cannot hold " << file->path
+                                  << " (" << file->size << " bytes)" << std::endl;
+        return false;
+    }
 
-                std::string archive_suffix = "_";
-                if (file->archive_index < 10) {
-                    archive_suffix += "00" + std::to_string(file->archive_index);
-                } else if (file->archive_index < 100) {
-                    archive_suffix += "0" + std::to_string(file->archive_index);
-                } else {
-                    archive_suffix += std::to_string(file->archive_index);
-                }
+    try {
+        uint32_t preload_size = std::min(file->preload_size, file->size);
+        uint32_t archive_length = file->size - preload_size;
 
-                data_file_path = archive_path.parent_path() / (stem + archive_suffix + ".vpk");
-            }
+        if (preload_size > 0 && !read_preload(archive_path, *file, buffer)) {
+            return false;
+        }
+        bytes_read = preload_size;
+
+        if (archive_length == 0) {
+            return true;
+        }
+
+        auto table = get_volumes(archive_path);
+        if (!table) {
+            std::cerr << "[ERROR] VPK: Cannot resolve data volumes for " << archive_path.string() << std::endl;
+            return false;
         }
 
-        if (read_from_data_file(data_file_path, file, data)) {
+        if (file->archive_index == vpk::EMBEDDED_ARCHIVE_INDEX) {
+            if (!read_embedded(archive_path, *table, file->offset, archive_length, buffer + preload_size)) {
+                return false;
+            }
+            bytes_read = file->size;
             return true;
         }
 
-        std::cerr << "[WARNING] VPK: Direct data file open failed for "
-                                  << data_file_path.string()
-                                  << ", attempting fallback search across all VPK data archives in directory"
-                                  << std::endl;
+        size_t volume_bytes = 0;
+        auto volume = table->volumes.find(file->archive_index);
+        if (volume != table->volumes.end()) {
+            if (read_from_volume(volume->second, file->offset, archive_length, buffer + preload_size, volume_bytes)) {
+                bytes_read += volume_bytes;
+                return true;
+            }
+            std::cerr << "[WARNING] VPK: Direct read failed for " << volume->second.path.string()
+                                      << ", attempting fallback search across all VPK data archives" << std::endl;
+        } else {
+            std::cerr << "[WARNING] VPK: No data volume with index " << file->archive_index
+                                      << ", attempting fallback search across all VPK data archives" << std::endl;
+        }
 
-        if (fallback_search_data_archives(archive_path, file, data)) {
+        if (fallback_search_data_archives(*table, *file, buffer + preload_size, volume_bytes)) {
+            bytes_read += volume_bytes;
             return true;
         }
 
         std::cerr << "[ERROR] VPK: Failed to locate data for file: " << file->path << std::endl;
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "[ERROR] VPK: Exception in extract_file: " << e.what() << std::endl;
+        std::cerr << "[ERROR] VPK: Exception in extract_into: " << e.what() << std::endl;
         return false;
     }
 }
 
-bool VpkParser::read_from_data_file(const fs::path& data_file_path,
-                                    const std::shared_ptr<FileEntry>& file,
-                                    std::vector<uint8_t>& data) const {
+EntryStream VpkParser::open_entry(const fs::path& archive_path,
+                                  const std::shared_ptr<FileEntry>& file) const {
+    if (!file) {
+        std::cerr << "[ERROR] VPK: Invalid file entry" << std::endl;
+        return EntryStream();
+    }
+
     try {
-        std::ifstream ifs(data_file_path, std::ios::binary);
-        if (!ifs.is_open()) {
-            DEBUG_CERR("[DEBUG] VPK: Could not open data file: " << data_file_path.string() << std::endl);
-            return false;
+        uint32_t preload_size = std::min(file->preload_size, file->size);
+        uint32_t archive_length = file->size - preload_size;
+        bool embedded = archive_length > 0 && file->archive_index == vpk::EMBEDDED_ARCHIVE_INDEX;
+
+        std::vector<EntrySegment> segments;
+        std::shared_ptr<const MappedFile> mapping;
+        if (preload_size > 0 || embedded) {
+            mapping = get_directory_mapping(archive_path);
+            if (!mapping || !mapping->data()) {
+                std::cerr << "[ERROR] VPK: Cannot map directory file: " << archive_path.string() << std::endl;
+                return EntryStream();
+            }
         }
 
-        ifs.seekg(0, std::ios::end);
-        std::streamoff total_size = ifs.tellg();
-        if (file->offset >= static_cast<uint32_t>(total_size) ||
-            static_cast<std::uint64_t>(file->offset) + static_cast<std::uint64_t>(file->size) > static_cast<std::uint64_t>(total_size)) {
-            DEBUG_CERR("[DEBUG] VPK: Data range out of bounds in "
-                                              << data_file_path.string()
-                                              << " (offset=" << file->offset
-                                              << ", size=" << file->size
-                                              << ", total=" << total_size << ")" << std::endl);
-            return false;
+        if (preload_size > 0) {
+            if (static_cast<uint64_t>(file->preload_offset) + preload_size > mapping->size()) {
+                std::cerr << "[ERROR] VPK: Preload data out of bounds for " << file->path << std::endl;
+                return EntryStream();
+            }
+            segments.push_back(EntrySegment::from_memory(mapping, mapping->data() + file->preload_offset, preload_size));
         }
 
-        ifs.seekg(file->offset, std::ios::beg);
-        if (!ifs.good()) {
-            DEBUG_CERR("[DEBUG] VPK: Failed to seek to offset " << file->offset
-                                              << " in " << data_file_path.string() << std::endl);
-            return false;
+        if (archive_length == 0) {
+            return EntryStream(std::move(segments));
         }
 
-        data.resize(file->size);
-        ifs.read(reinterpret_cast<char*>(data.data()), file->size);
-
-        if (!ifs.good() && !ifs.eof()) {
-            DEBUG_CERR("[DEBUG] VPK: Read error from data file: " << data_file_path.string() << std::endl);
-            return false;
+        auto table = get_volumes(archive_path);
+        if (!table) {
+            std::cerr << "[ERROR] VPK: Cannot resolve data volumes for " << archive_path.string() << std::endl;
+            return EntryStream();
         }
 
-        size_t bytes_read = static_cast<size_t>(ifs.gcount());
-        if (bytes_read == 0) {
-            DEBUG_CERR("[DEBUG] VPK: Zero bytes read from data file: " << data_file_path.string() << std::endl);
-            return false;
+        if (embedded) {
+            uint64_t start = table->embedded_data_offset + file->offset;
+            if (start + archive_length > mapping->size()) {
+                std::cerr << "[ERROR] VPK: Embedded data out of bounds (offset=" << start
+                                                  << ", size=" << archive_length << ")" << std::endl;
+                return EntryStream();
+            }
+            segments.push_back(EntrySegment::from_memory(mapping, mapping->data() + start, archive_length));
+            return EntryStream(std::move(segments));
         }
 
-        if (bytes_read != file->size) {
-            std::cerr << "[WARNING] VPK: Expected to read " << file->size
-                                              << " bytes, but read " << bytes_read
-                                              << " bytes from " << data_file_path.string() << std::endl;
-            data.resize(bytes_read);
+        auto volume = table->volumes.find(file->archive_index);
+        if (volume != table->volumes.end() &&
+            static_cast<uint64_t>(file->offset) + archive_length <= volume->second.size) {
+            auto handle = handle_pool.acquire(volume->second.path);
+            if (handle) {
+                segments.push_back(EntrySegment::from_file(std::move(handle), file->offset, archive_length));
+                return EntryStream(std::move(segments));
+            }
         }
 
-        return true;
+        // The data is not where the tree says; extract_file searches the other volumes
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        if (!extract_file(archive_path, file, *data)) {
+            return EntryStream();
+        }
+        const uint8_t* bytes = data->data();
+        uint64_t length = data->size();
+        return EntryStream({EntrySegment::from_memory(std::move(data), bytes, length)});
     } catch (const std::exception& e) {
-        std::cerr << "[ERROR] VPK: Exception in read_from_data_file("
-                                  << data_file_path.string() << "): " << e.what() << std::endl;
-        return false;
+        std::cerr << "[ERROR] VPK: Exception in open_entry: " << e.what() << std::endl;
+        return EntryStream();
     }
 }
 
-bool VpkParser::fallback_search_data_archives(const fs::path& archive_path,
-                                                                                              const std::shared_ptr<FileEntry>& file,
-                                                                                              std::vector<uint8_t>& data) const {
-    try {
-        fs::path dir = archive_path.parent_path();
-        if (!fs::exists(dir) || !fs::is_directory(dir)) {
-            DEBUG_CERR("[DEBUG] VPK: Parent directory does not exist or is not a directory: "
-                                              << dir.string() << std::endl);
-            return false;
+size_t VpkParser::extract_files(const fs::path& archive_path,
+                                                                const std::vector<std::shared_ptr<FileEntry>>& files,
+                                                                const ExtractCallback& on_extracted,
+                                                                uint32_t read_threads) const {
+    size_t extracted = 0;
+    auto finish = [&](size_t index, bool success, std::vector<uint8_t>& data) {
+        if (success) ++extracted;
+        if (on_extracted) on_extracted(files[index], success, data);
+    };
+
+    auto table = get_volumes(archive_path);
+    std::map<uint32_t, std::vector<PendingRead>> reads_by_volume;
+    std::vector<uint8_t> data;
+
+    // Entries without volume data are served from the directory file right away; anything the
+    // batch path cannot place goes through extract_file and its fallback search
+    for (size_t i = 0; i < files.size(); ++i) {
+        const auto& file = files[i];
+        if (!file) {
+            data.clear();
+            finish(i, false, data);
+            continue;
         }
 
-        std::string stem = archive_path.stem().string();
-        std::string prefix = stem;
-        const std::string dir_suffix = "_dir";
-        auto pos = prefix.rfind(dir_suffix);
-        if (pos != std::string::npos) {
-            prefix.erase(pos, dir_suffix.length());
+        uint32_t archive_length = file->size - std::min(file->preload_size, file->size);
+        bool batched = archive_length > 0 && table &&
+                                          file->archive_index != vpk::EMBEDDED_ARCHIVE_INDEX &&
+                                          table->volumes.count(file->archive_index) > 0;
+        if (!batched) {
+            data.clear();
+            bool success = extract_file(archive_path, file, data);
+            finish(i, success, data);
+            continue;
         }
-        prefix += "_";
 
-        bool any_tried = false;
+        reads_by_volume[file->archive_index].push_back({i, file->offset, archive_length});
+    }
 
-        for (const auto& entry : fs::directory_iterator(dir)) {
-            if (!entry.is_regular_file()) continue;
+    // Split each volume's reads into runs that one vectored read can serve
+    std::vector<ReadRun> runs;
+    for (auto& [archive_index, reads] : reads_by_volume) {
+        const DataVolume& volume = table->volumes.at(archive_index);
+        std::sort(reads.begin(), reads.end(), [](const PendingRead& a, const PendingRead& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.index < b.index;
+        });
+
+        auto handle = handle_pool.acquire(volume.path);
+
+        size_t run_begin = 0;
+        while (run_begin < reads.size()) {
+            uint64_t run_start = reads[run_begin].offset;
+            uint64_t run_end = run_start + reads[run_begin].length;
+            size_t run_stop = run_begin + 1;
+
+            // Overlapping entries cannot share one vectored read, so they start a new run
+            while (run_stop < reads.size()) {
+                const PendingRead& next = reads[run_stop];
+                uint64_t next_end = next.offset + next.length;
+                if (next.offset < run_end ||
+                    next.offset - run_end > MAX_COALESCE_GAP ||
+                    next_end - run_start > MAX_COALESCED_SPAN) {
+                    break;
+                }
+                run_end = next_end;
+                ++run_stop;
+            }
 
-            const auto& p = entry.path();
-            if (!p.has_extension() || p.extension() != ".vpk") continue;
+            bool readable = handle && run_end <= volume.size;
+            runs.push_back({readable ? handle : nullptr, &reads, run_begin, run_stop, run_start, run_end});
+            run_begin = run_stop;
+        }
+    }
 
-            std::string fname = p.filename().string();
-            if (fname.find("_dir.vpk") != std::string::npos) continue;
-            if (fname.rfind(prefix, 0) != 0) continue; // must start with prefix
+    if (runs.empty()) {
+        return extracted;
+    }
 
-            any_tried = true;
-            DEBUG_CERR("[DEBUG] VPK: Fallback trying data archive: " << p.string() << std::endl);
+    // Runs are read in windows, each submitted as one batch so many reads are in flight at once.
+    // Holes between entries land in a scratch buffer and are discarded; every run has its own,
+    // since the runs of a window may be read concurrently and no two reads may share a target.
+    AsyncReader reader(ASYNC_QUEUE_DEPTH, read_threads != 0 ? read_threads : get_thread_count());
+    std::vector<std::vector<uint8_t>> gap_buffers;
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<IoSlice> slices;
+    std::vector<size_t> first_slice;
+    std::vector<ReadRequest> requests;
+
+    size_t window_begin = 0;
+    while (window_begin < runs.size()) {
+        size_t window_end = window_begin;
+        uint64_t window_bytes = 0;
+        size_t window_entries = 0;
+        while (window_end < runs.size() && window_end - window_begin < ASYNC_QUEUE_DEPTH &&
+               (window_end == window_begin || window_bytes < MAX_WINDOW_BYTES)) {
+            window_bytes += runs[window_end].end - runs[window_end].start;
+            window_entries += runs[window_end].read_end - runs[window_end].read_begin;
+            ++window_end;
+        }
 
-            if (read_from_data_file(p, file, data)) {
-                std::cerr << "[INFO] VPK: Fallback successfully read file data from "
-                                                  << p.string() << std::endl;
-                return true;
+        buffers.resize(window_entries);
+        gap_buffers.resize(window_end - window_begin);
+        slices.clear();
+        first_slice.clear();
+        requests.clear();
+
+        size_t buffer_index = 0;
+        for (size_t r = window_begin; r < window_end; ++r) {
+            const ReadRun& run = runs[r];
+            first_slice.push_back(slices.size());
+
+            // Reads in a run are sorted and never overlap, so every gap is non-negative
+            uint64_t largest_gap = 0;
+            for (size_t k = run.read_begin + 1; k < run.read_end; ++k) {
+                const PendingRead& previous = (*run.reads)[k - 1];
+                largest_gap = std::max(largest_gap, (*run.reads)[k].offset - (previous.offset + previous.length));
+            }
+            auto& gap_buffer = gap_buffers[r - window_begin];
+            gap_buffer.resize(static_cast<size_t>(largest_gap));
+
+            uint64_t cursor = run.start;
+            for (size_t k = run.read_begin; k < run.read_end; ++k) {
+                const PendingRead& read = (*run.reads)[k];
+                const auto& file = files[read.index];
+                auto& buffer = buffers[buffer_index++];
+                buffer.resize(file->size);
+
+                if (read.offset > cursor) {
+                    slices.push_back({gap_buffer.data(), static_cast<size_t>(read.offset - cursor)});
+                }
+                slices.push_back({buffer.data() + (file->size - read.length), read.length});
+                cursor = read.offset + read.length;
             }
         }
+        first_slice.push_back(slices.size());
+
+        for (size_t r = window_begin; r < window_end; ++r) {
+            size_t w = r - window_begin;
+            ReadRequest request;
+            request.file = runs[r].handle.get();
+            request.offset = runs[r].start;
+            request.slices = slices.data() + first_slice[w];
+            request.slice_count = first_slice[w + 1] - first_slice[w];
+            requests.push_back(request);
+        }
 
-        if (!any_tried) {
-            std::cerr << "[WARNING] VPK: No matching VPK data archives found for prefix '"
-                                              << prefix << "' in directory " << dir.string() << std::endl;
-        } else {
-            std::cerr << "[WARNING] VPK: Fallback search did not find valid data for file: "
-                                              << file->path << std::endl;
+        reader.read_all(requests);
+
+        buffer_index = 0;
+        for (size_t r = window_begin; r < window_end; ++r) {
+            const ReadRun& run = runs[r];
+            bool run_ok = requests[r - window_begin].bytes_read == run.end - run.start;
+
+            for (size_t k = run.read_begin; k < run.read_end; ++k) {
+                const PendingRead& read = (*run.reads)[k];
+                const auto& file = files[read.index];
+                auto& buffer = buffers[buffer_index++];
+
+                bool success;
+                if (run_ok) {
+                    uint32_t preload_size = file->size - read.length;
+                    success = preload_size == 0 || read_preload(archive_path, *file, buffer.data());
+                } else {
+                    buffer.clear();
+                    success = extract_file(archive_path, file, buffer);
+                }
+                finish(read.index, success, buffer);
+            }
+        }
+
+        window_begin = window_end;
+    }
+
+    DEBUG_COUT("[DEBUG] VPK: Batch extracted " << extracted << "/" << files.size() << " entries" << std::endl);
+
+    return extracted;
+}
+
+SectionChecksumReport VpkParser::verify_section_checksums(const fs::path& archive_path) const {
+    SectionChecksumReport report;
+
+    auto mapping = get_directory_mapping(archive_path);
+    if (!mapping || !mapping->data() || mapping->size() < vpk::V2_HEADER_SIZE) {
+        return report;
+    }
+
+    const uint8_t* base = mapping->data();
+    uint32_t header[7];
+    std::memcpy(header, base, sizeof(header));
+    if (header[0] != vpk::SIGNATURE || header[1] != 2) {
+        return report;
+    }
+
+    const uint32_t tree_size = header[2];
+    const uint32_t file_data_section_size = header[3];
+    const uint32_t archive_md5_section_size = header[4];
+    const uint32_t other_md5_section_size = header[5];
+    if (archive_md5_section_size == 0 && other_md5_section_size == 0) {
+        return report;
+    }
+
+    report.present = true;
+
+    const uint64_t archive_md5_offset = static_cast<uint64_t>(vpk::V2_HEADER_SIZE) + tree_size + file_data_section_size;
+    const uint64_t other_md5_offset = archive_md5_offset + archive_md5_section_size;
+    if (other_md5_offset + other_md5_section_size > mapping->size() ||
+        (other_md5_section_size != 0 && other_md5_section_size < vpk::OTHER_MD5_SECTION_SIZE)) {
+        report.chunks_failed = 1;
+        report.failures.push_back("VPK checksum sections extend past the end of " + archive_path.filename().string());
+        return report;
+    }
+
+    std::vector<ArchiveMd5Entry> entries(archive_md5_section_size / vpk::ARCHIVE_MD5_ENTRY_SIZE);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const uint8_t* record = base + archive_md5_offset + i * vpk::ARCHIVE_MD5_ENTRY_SIZE;
+        std::memcpy(&entries[i].archive_index, record, 4);
+        std::memcpy(&entries[i].offset, record + 4, 4);
+        std::memcpy(&entries[i].length, record + 8, 4);
+        std::memcpy(entries[i].expected.data(), record + 12, 16);
+    }
+
+    auto table = get_volumes(archive_path);
+
+    // Task 0 covers the digests of the directory file itself; every other task hashes one chunk
+    const size_t task_count = entries.size() + 1;
+    std::vector<std::vector<std::string>> failures(task_count);
+    std::vector<uint32_t> checked(task_count, 0);
+    std::vector<uint64_t> hashed(task_count, 0);
+
+    auto check = [&](size_t task, const std::string& what, const Md5Digest& expected, const Md5Digest& actual) {
+        checked[task]++;
+        if (expected != actual) {
+            failures[task].push_back("MD5 mismatch in " + what + " (expected " + Md5::to_hex(expected) +
+                                     ", got " + Md5::to_hex(actual) + ")");
+        }
+    };
+
+    auto verify_task = [&](size_t task) {
+        if (task == 0) {
+            if (other_md5_section_size == 0) return;
+
+            Md5Digest expected;
+            const uint8_t* other = base + other_md5_offset;
+
+            std::memcpy(expected.data(), other, 16);
+            check(0, "directory tree", expected, Md5::digest(base + vpk::V2_HEADER_SIZE, tree_size));
+
+            std::memcpy(expected.data(), other + 16, 16);
+            check(0, "archive MD5 section", expected, Md5::digest(base + archive_md5_offset, archive_md5_section_size));
+
+            // The whole-file digest covers everything before itself
+            std::memcpy(expected.data(), other + 32, 16);
+            check(0, "directory file", expected, Md5::digest(base, static_cast<size_t>(other_md5_offset + 32)));
+
+            hashed[0] = tree_size + archive_md5_section_size + other_md5_offset + 32;
+            return;
         }
 
+        const ArchiveMd5Entry& entry = entries[task - 1];
+        std::string what = "archive " + std::to_string(entry.archive_index) + " chunk at " +
+                           std::to_string(entry.offset) + "+" + std::to_string(entry.length);
+
+        if (entry.archive_index == vpk::EMBEDDED_ARCHIVE_INDEX) {
+            uint64_t start = (table ? table->embedded_data_offset : 0) + entry.offset;
+            if (!table || start + entry.length > mapping->size()) {
+                checked[task]++;
+                failures[task].push_back("Cannot read " + what + ": out of bounds");
+                return;
+            }
+            check(task, what, entry.expected, Md5::digest(base + start, entry.length));
+            hashed[task] = entry.length;
+            return;
+        }
+
+        const DataVolume* volume = nullptr;
+        if (table) {
+            auto found = table->volumes.find(entry.archive_index);
+            if (found != table->volumes.end()) volume = &found->second;
+        }
+        if (!volume || static_cast<uint64_t>(entry.offset) + entry.length > volume->size) {
+            checked[task]++;
+            failures[task].push_back("Cannot read " + what + ": volume missing or too short");
+            return;
+        }
+
+        auto handle = handle_pool.acquire(volume->path);
+        if (!handle) {
+            checked[task]++;
+            failures[task].push_back("Cannot read " + what + ": failed to open " + volume->path.string());
+            return;
+        }
+
+        Md5 md5;
+        std::vector<uint8_t> block(std::min<size_t>(entry.length, MD5_READ_BLOCK));
+        uint64_t position = entry.offset;
+        uint32_t remaining = entry.length;
+        while (remaining > 0) {
+            size_t want = std::min<size_t>(remaining, block.size());
+            if (handle->read_at(position, block.data(), want) != want) {
+                checked[task]++;
+                failures[task].push_back("Cannot read " + what + ": short read");
+                return;
+            }
+            md5.update(block.data(), want);
+            position += want;
+            remaining -= static_cast<uint32_t>(want);
+        }
+
+        check(task, what, entry.expected, md5.finalize());
+        hashed[task] = entry.length;
+    };
+
+    ThreadPool::run(task_count, thread_count, verify_task);
+
+    for (size_t task = 0; task < task_count; ++task) {
+        report.chunks_checked += checked[task];
+        report.chunks_failed += static_cast<uint32_t>(failures[task].size());
+        report.bytes_hashed += hashed[task];
+        report.failures.insert(report.failures.end(), failures[task].begin(), failures[task].end());
+    }
+
+    std::ostringstream oss;
+    oss << "VPK: Checked " << report.chunks_checked << " MD5 sections, " << report.chunks_failed << " failed";
+    Logger::instance().info(oss.str());
+
+    return report;
+}
+
+std::shared_ptr<MappedFile> VpkParser::open_directory(const fs::path& archive_path) const {
+    auto mapping = std::make_shared<MappedFile>();
+    bool opened = pin_files ? mapping->read(archive_path) : mapping->open(archive_path);
+    return opened ? mapping : nullptr;
+}
+
+void VpkParser::open_pinned_files(const fs::path& archive_path) const {
+    auto table = get_volumes(archive_path);
+    if (!table) return;
+    for (const auto& volume : table->volumes) {
+        handle_pool.acquire(volume.second.path);
+    }
+}
+
+std::shared_ptr<const MappedFile> VpkParser::get_directory_mapping(const fs::path& archive_path) const {
+    std::lock_guard<std::mutex> lock(mapping_mutex);
+    if (directory_mapping && directory_mapping_path == archive_path) {
+        return directory_mapping;
+    }
+
+    // Entries restored from the index cache arrive without a parse, so map on first use
+    auto mapping = open_directory(archive_path);
+    if (!mapping) {
+        return nullptr;
+    }
+    directory_mapping = mapping;
+    directory_mapping_path = archive_path;
+    return directory_mapping;
+}
+
+std::shared_ptr<const VpkParser::VolumeTable> VpkParser::get_volumes(const fs::path& archive_path) const {
+    {
+        std::lock_guard<std::mutex> lock(mapping_mutex);
+        if (volume_table && volume_table->archive_path == archive_path) {
+            return volume_table;
+        }
+    }
+
+    auto mapping = get_directory_mapping(archive_path);
+    auto table = discover_volumes(archive_path, mapping.get());
+
+    std::lock_guard<std::mutex> lock(mapping_mutex);
+    volume_table = table;
+    return volume_table;
+}
+
+std::shared_ptr<const VpkParser::VolumeTable> VpkParser::discover_volumes(const fs::path& archive_path,
+                                                                                                                      const MappedFile* mapping) {
+    auto table = std::make_shared<VolumeTable>();
+    table->archive_path = archive_path;
+
+    // Data stored in the directory file itself starts right after the tree
+    if (mapping && mapping->data() && mapping->size() >= 12) {
+        uint32_t header[3] = {0, 0, 0};
+        std::memcpy(header, mapping->data(), sizeof(header));
+        if (header[0] == vpk::SIGNATURE) {
+            uint64_t header_size = header[1] == 2 ? vpk::V2_HEADER_SIZE : vpk::V1_HEADER_SIZE;
+            table->embedded_data_offset = header_size + header[2];
+        }
+    }
+
+    std::string prefix = archive_path.stem().string();
+    const std::string dir_suffix = "_dir";
+    if (prefix.size() >= dir_suffix.size() &&
+        to_lower_ascii(prefix.substr(prefix.size() - dir_suffix.size())) == dir_suffix) {
+        prefix.erase(prefix.size() - dir_suffix.size());
+    }
+    prefix = to_lower_ascii(prefix) + "_";
+
+    fs::path dir = archive_path.parent_path();
+    if (dir.empty()) {
+        dir = ".";
+    }
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) continue;
+
+        const auto& p = it->path();
+        std::string fname = to_lower_ascii(p.filename().string());
+        if (fname.size() <= prefix.size() + 4 || fname.compare(0, prefix.size(), prefix) != 0) continue;
+        if (fname.compare(fname.size() - 4, 4, ".vpk") != 0) continue;
+
+        std::string digits = fname.substr(prefix.size(), fname.size() - prefix.size() - 4);
+        if (digits.empty() || digits.size() > 5 ||
+            !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+
+        DataVolume volume;
+        volume.path = p;
+        volume.size = it->file_size(entry_ec);
+        if (entry_ec) continue;
+
+        table->volumes[static_cast<uint32_t>(std::stoul(digits))] = volume;
+    }
+
+    std::ostringstream oss;
+    oss << "VPK: Found " << table->volumes.size() << " data volumes for " << archive_path.filename().string();
+    Logger::instance().info(oss.str());
+
+    return table;
+}
+
+bool VpkParser::read_preload(const fs::path& archive_path,
+                                                 const FileEntry& file,
+                                                 uint8_t* destination) const {
+    auto mapping = get_directory_mapping(archive_path);
+    if (!mapping || !mapping->data()) {
+        std::cerr << "[ERROR] VPK: Cannot map directory file for preload data: " << archive_path.string() << std::endl;
         return false;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] VPK: Exception in fallback_search_data_archives: "
-                                  << e.what() << std::endl;
+    }
+
+    uint64_t preload_end = static_cast<uint64_t>(file.preload_offset) + file.preload_size;
+    if (preload_end > mapping->size()) {
+        std::cerr << "[ERROR] VPK: Preload data out of bounds for " << file.path
+                                          << " (offset=" << file.preload_offset
+                                          << ", size=" << file.preload_size << ")" << std::endl;
+        return false;
+    }
+
+    std::memcpy(destination, mapping->data() + file.preload_offset, file.preload_size);
+    return true;
+}
+
+bool VpkParser::read_embedded(const fs::path& archive_path,
+                                                  const VolumeTable& table,
+                                                  uint64_t offset,
+                                                  uint32_t length,
+                                                  uint8_t* destination) const {
+    auto mapping = get_directory_mapping(archive_path);
+    if (!mapping || !mapping->data()) {
+        std::cerr << "[ERROR] VPK: Cannot map directory file: " << archive_path.string() << std::endl;
+        return false;
+    }
+
+    uint64_t start = table.embedded_data_offset + offset;
+    if (start + length > mapping->size()) {
+        std::cerr << "[ERROR] VPK: Embedded data out of bounds (offset=" << start
+                                          << ", size=" << length << ", total=" << mapping->size() << ")" << std::endl;
+        return false;
+    }
+
+    std::memcpy(destination, mapping->data() + start, length);
+    return true;
+}
+
+bool VpkParser::read_from_volume(const DataVolume& volume,
+                                 uint64_t offset,
+                                 uint32_t length,
+                                 uint8_t* destination,
+                                 size_t& bytes_read) const {
+    bytes_read = 0;
+    if (offset >= volume.size || offset + static_cast<uint64_t>(length) > volume.size) {
+        DEBUG_CERR("[DEBUG] VPK: Data range out of bounds in "
+                                          << volume.path.string()
+                                          << " (offset=" << offset
+                                          << ", size=" << length
+                                          << ", total=" << volume.size << ")" << std::endl);
         return false;
     }
+
+    auto handle = handle_pool.acquire(volume.path);
+    if (!handle) {
+        DEBUG_CERR("[DEBUG] VPK: Could not open data file: " << volume.path.string() << std::endl);
+        return false;
+    }
+
+    bytes_read = handle->read_at(offset, destination, length);
+
+    if (bytes_read == 0) {
+        DEBUG_CERR("[DEBUG] VPK: Zero bytes read from data file: " << volume.path.string() << std::endl);
+        return false;
+    }
+
+    if (bytes_read != length) {
+        std::cerr << "[WARNING] VPK: Expected to read " << length
+                                          << " bytes, but read " << bytes_read
+                                          << " bytes from " << volume.path.string() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool VpkParser::fallback_search_data_archives(const VolumeTable& table,
+                                                                                              const FileEntry& file,
+                                                                                              uint8_t* destination,
+                                                                                              size_t& bytes_read) const {
+    bytes_read = 0;
+    if (table.volumes.empty()) {
+        std::cerr << "[WARNING] VPK: No matching VPK data archives found for "
+                                          << table.archive_path.filename().string() << std::endl;
+        return false;
+    }
+
+    uint32_t preload_size = std::min(file.preload_size, file.size);
+    for (const auto& [index, volume] : table.volumes) {
+        if (index == file.archive_index) continue;
+
+        DEBUG_CERR("[DEBUG] VPK: Fallback trying data archive: " << volume.path.string() << std::endl);
+
+        if (read_from_volume(volume, file.offset, file.size - preload_size, destination, bytes_read)) {
+            std::cerr << "[INFO] VPK: Fallback successfully read file data from "
+                                              << volume.path.string() << std::endl;
+            return true;
+        }
+    }
+
+    std::cerr << "[WARNING] VPK: Fallback search did not find valid data for file: "
+                                      << file.path << std::endl;
+    return false;
 }
 
 } // namespace unpaker::parsers
@@ -0,0 +1,476 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "vpk_writer.hpp"
+#include "vpk_format.hpp"
+#include "ascii.hpp"
+#include "crc32.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include "random_access_file.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+namespace unpaker::parsers {
+
+namespace {
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    size_t pos = out.size();
+    out.resize(pos + sizeof(T));
+    std::memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+void put_cstring(std::vector<uint8_t>& out, const std::string& text) {
+    out.insert(out.end(), text.begin(), text.end());
+    out.push_back('\0');
+}
+
+bool is_valid_name(const std::string& name, size_t max_length) {
+    if (name.empty() || name.size() > max_length) return false;
+    for (char c : name) {
+        if (static_cast<unsigned char>(c) < 32 || static_cast<unsigned char>(c) > 126) return false;
+    }
+    return true;
+}
+
+bool write_file(const fs::path& path, const std::vector<uint8_t>& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return out.good();
+}
+
+// Deletes "<prefix>_NNN.vpk" volumes numbered volume_count or higher, matched the way the parser
+// discovers volumes, so a rebuilt set never picks up data left over from a larger one
+uint32_t remove_stale_volumes(const fs::path& dir, std::string prefix, size_t volume_count) {
+    prefix += '_';
+    std::transform(prefix.begin(), prefix.end(), prefix.begin(), [](char c) { return fold_ascii(c); });
+
+    std::vector<fs::path> stale;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir.empty() ? fs::path(".") : dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) continue;
+
+        std::string fname = it->path().filename().string();
+        std::transform(fname.begin(), fname.end(), fname.begin(), [](char c) { return fold_ascii(c); });
+        if (fname.size() <= prefix.size() + 4 || fname.compare(0, prefix.size(), prefix) != 0) continue;
+        if (fname.compare(fname.size() - 4, 4, ".vpk") != 0) continue;
+
+        std::string digits = fname.substr(prefix.size(), fname.size() - prefix.size() - 4);
+        if (digits.empty() || digits.size() > 5 ||
+            !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        if (std::stoul(digits) >= volume_count) {
+            stale.push_back(it->path());
+        }
+    }
+
+    uint32_t removed = 0;
+    for (const auto& path : stale) {
+        if (fs::remove(path, ec) || !ec) {
+            ++removed;
+        } else {
+            std::cerr << "[WARNING] VPK Writer: Cannot remove stale volume " << path.string() << ": "
+                      << ec.message() << std::endl;
+        }
+    }
+    return removed;
+}
+
+} // namespace
+
+VpkWriter::VpkWriter(const VpkWriterOptions& options) : options(options) {
+    // Offsets inside a volume are stored as u32
+    this->options.max_volume_size = std::min<uint64_t>(std::max<uint64_t>(options.max_volume_size, 1),
+                                                       std::numeric_limits<uint32_t>::max());
+    this->options.md5_chunk_size = std::max<uint32_t>(options.md5_chunk_size, 4096);
+}
+
+bool VpkWriter::add_file(const std::string& archive_path, const fs::path& source, uint32_t preload_size) {
+    PendingEntry entry;
+    entry.source = source;
+    entry.requested_preload = preload_size;
+    return add_entry(archive_path, std::move(entry));
+}
+
+bool VpkWriter::add_data(const std::string& archive_path, std::vector<uint8_t> data, uint32_t preload_size) {
+    PendingEntry entry;
+    entry.data = std::move(data);
+    entry.in_memory = true;
+    entry.requested_preload = preload_size;
+    return add_entry(archive_path, std::move(entry));
+}
+
+bool VpkWriter::add_entry(const std::string& archive_path, PendingEntry entry) {
+    std::string path = archive_path;
+    std::replace(path.begin(), path.end(), '\\', '/');
+    size_t start = path.find_first_not_of('/');
+    path.erase(0, start == std::string::npos ? path.size() : start);
+
+    size_t last_slash = path.find_last_of('/');
+    std::string file_name = last_slash == std::string::npos ? path : path.substr(last_slash + 1);
+    entry.directory = last_slash == std::string::npos ? std::string(vpk::EMPTY_NAME) : path.substr(0, last_slash);
+
+    size_t dot = file_name.find_last_of('.');
+    if (dot == std::string::npos || dot + 1 == file_name.size()) {
+        entry.stem = file_name.substr(0, dot);
+        entry.extension = vpk::EMPTY_NAME;
+    } else {
+        entry.stem = file_name.substr(0, dot);
+        entry.extension = file_name.substr(dot + 1);
+    }
+
+    if (!is_valid_name(entry.stem, vpk::MAX_NAME_LENGTH) || !is_valid_name(entry.directory, vpk::MAX_NAME_LENGTH) ||
+        !is_valid_name(entry.extension, vpk::MAX_EXTENSION_LENGTH)) {
+        std::cerr << "[ERROR] VPK Writer: Cannot store \"" << archive_path
+                  << "\": names must be printable ASCII, non-empty and at most "
+                  << vpk::MAX_NAME_LENGTH << " characters" << std::endl;
+        return false;
+    }
+
+    entries.push_back(std::move(entry));
+    return true;
+}
+
+bool VpkWriter::load(const PendingEntry& entry, std::vector<uint8_t>& buffer) const {
+    if (entry.in_memory) {
+        buffer = entry.data;
+        return true;
+    }
+
+    RandomAccessFile file;
+    if (!file.open(entry.source)) {
+        return false;
+    }
+    if (file.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    buffer.resize(static_cast<size_t>(file.size()));
+    return file.read_at(0, buffer.data(), buffer.size()) == buffer.size();
+}
+
+bool VpkWriter::hash_entries(std::vector<std::string>& errors) {
+    std::vector<std::string> task_errors(entries.size());
+
+    ThreadPool::run(entries.size(), options.thread_count, [&](size_t i) {
+        PendingEntry& entry = entries[i];
+        std::vector<uint8_t> scratch;
+        const std::vector<uint8_t>* content = &entry.data;
+        if (!entry.in_memory) {
+            if (!load(entry, scratch)) {
+                task_errors[i] = "Cannot read " + entry.source.string();
+                return;
+            }
+            content = &scratch;
+        } else if (entry.data.size() > std::numeric_limits<uint32_t>::max()) {
+            task_errors[i] = "Entry " + entry.stem + " is larger than 4 GB";
+            return;
+        }
+
+        uint32_t preload = std::min<uint64_t>({entry.requested_preload, vpk::MAX_PRELOAD_SIZE, content->size()});
+        entry.size = content->size();
+        entry.crc = crc32(content->data(), content->size());
+        entry.preload.assign(content->begin(), content->begin() + preload);
+        entry.length = static_cast<uint32_t>(content->size() - preload);
+        if (options.deduplicate && entry.length > 0) {
+            entry.content_digest = Md5::digest(content->data() + preload, entry.length);
+        }
+    });
+
+    for (auto& error : task_errors) {
+        if (!error.empty()) errors.push_back(std::move(error));
+    }
+    return errors.empty();
+}
+
+bool VpkWriter::lay_out_volumes() {
+    volume_sizes.clear();
+    std::map<std::pair<Md5Digest, uint32_t>, size_t> stored;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        PendingEntry& entry = entries[i];
+        entry.duplicate = false;
+
+        if (entry.length == 0) {
+            entry.archive_index = static_cast<uint16_t>(vpk::EMBEDDED_ARCHIVE_INDEX);
+            entry.offset = 0;
+            continue;
+        }
+
+        if (options.deduplicate) {
+            auto found = stored.find({entry.content_digest, entry.length});
+            if (found != stored.end()) {
+                const PendingEntry& original = entries[found->second];
+                entry.archive_index = original.archive_index;
+                entry.offset = original.offset;
+                entry.duplicate = true;
+                last_report.deduplicated_entries++;
+                last_report.bytes_saved += entry.length;
+                continue;
+            }
+            stored.emplace(std::make_pair(entry.content_digest, entry.length), i);
+        }
+
+        if (volume_sizes.empty() ||
+            (volume_sizes.back() > 0 && volume_sizes.back() + entry.length > options.max_volume_size)) {
+            if (volume_sizes.size() >= vpk::EMBEDDED_ARCHIVE_INDEX) {
+                std::cerr << "[ERROR] VPK Writer: Too many data volumes; raise max_volume_size" << std::endl;
+                return false;
+            }
+            volume_sizes.push_back(0);
+        }
+
+        entry.archive_index = static_cast<uint16_t>(volume_sizes.size() - 1);
+        entry.offset = static_cast<uint32_t>(volume_sizes.back());
+        volume_sizes.back() += entry.length;
+    }
+
+    return true;
+}
+
+bool VpkWriter::write_volumes(const std::vector<fs::path>& volume_paths) {
+    std::vector<std::vector<size_t>> contents(volume_paths.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].length > 0 && !entries[i].duplicate) {
+            contents[entries[i].archive_index].push_back(i);
+        }
+    }
+
+    std::vector<std::string> errors(volume_paths.size());
+    ThreadPool::run(volume_paths.size(), options.thread_count, [&](size_t volume) {
+        std::ofstream out(volume_paths[volume], std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            errors[volume] = "Cannot create " + volume_paths[volume].string();
+            return;
+        }
+
+        std::vector<uint8_t> buffer;
+        for (size_t i : contents[volume]) {
+            const PendingEntry& entry = entries[i];
+            // Sources are read again here; catch files that changed since they were checksummed
+            if (!load(entry, buffer) || buffer.size() != entry.size || crc32(buffer.data(), buffer.size()) != entry.crc) {
+                errors[volume] = "Source changed while writing: " +
+                                 (entry.in_memory ? entry.stem : entry.source.string());
+                return;
+            }
+            out.write(reinterpret_cast<const char*>(buffer.data() + entry.preload.size()), entry.length);
+        }
+
+        if (!out.good()) {
+            errors[volume] = "Failed to write " + volume_paths[volume].string();
+        }
+    });
+
+    bool ok = true;
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            std::cerr << "[ERROR] VPK Writer: " << error << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::vector<uint8_t> VpkWriter::build_tree() const {
+    std::vector<uint8_t> tree;
+
+    // Entries are sorted by extension, then directory, which is the nesting the tree uses
+    size_t i = 0;
+    while (i < entries.size()) {
+        const std::string& extension = entries[i].extension;
+        put_cstring(tree, extension);
+
+        while (i < entries.size() && entries[i].extension == extension) {
+            const std::string& directory = entries[i].directory;
+            put_cstring(tree, directory);
+
+            for (; i < entries.size() && entries[i].extension == extension && entries[i].directory == directory; ++i) {
+                const PendingEntry& entry = entries[i];
+                put_cstring(tree, entry.stem);
+                put(tree, entry.crc);
+                put(tree, static_cast<uint16_t>(entry.preload.size()));
+                put(tree, entry.archive_index);
+                put(tree, entry.offset);
+                put(tree, entry.length);
+                put(tree, vpk::ENTRY_TERMINATOR);
+                tree.insert(tree.end(), entry.preload.begin(), entry.preload.end());
+            }
+            tree.push_back('\0');
+        }
+        tree.push_back('\0');
+    }
+    tree.push_back('\0');
+
+    return tree;
+}
+
+std::vector<uint8_t> VpkWriter::hash_volume_chunks(const std::vector<fs::path>& volume_paths, bool& ok) const {
+    struct Chunk {
+        uint32_t archive_index;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::vector<std::unique_ptr<MappedFile>> mappings;
+    std::vector<Chunk> chunks;
+    for (size_t v = 0; v < volume_paths.size(); ++v) {
+        auto mapping = std::make_unique<MappedFile>();
+        if (!mapping->open(volume_paths[v]) || mapping->size() != volume_sizes[v]) {
+            std::cerr << "[ERROR] VPK Writer: Cannot map " << volume_paths[v].string() << " for hashing" << std::endl;
+            ok = false;
+            return {};
+        }
+        for (uint64_t offset = 0; offset < volume_sizes[v]; offset += options.md5_chunk_size) {
+            uint32_t length = static_cast<uint32_t>(std::min<uint64_t>(options.md5_chunk_size, volume_sizes[v] - offset));
+            chunks.push_back({static_cast<uint32_t>(v), static_cast<uint32_t>(offset), length});
+        }
+        mappings.push_back(std::move(mapping));
+    }
+
+    std::vector<Md5Digest> digests(chunks.size());
+    ThreadPool::run(chunks.size(), options.thread_count, [&](size_t c) {
+        const Chunk& chunk = chunks[c];
+        digests[c] = Md5::digest(mappings[chunk.archive_index]->data() + chunk.offset, chunk.length);
+    });
+
+    std::vector<uint8_t> section;
+    section.reserve(chunks.size() * vpk::ARCHIVE_MD5_ENTRY_SIZE);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        put(section, chunks[c].archive_index);
+        put(section, chunks[c].offset);
+        put(section, chunks[c].length);
+        section.insert(section.end(), digests[c].begin(), digests[c].end());
+    }
+
+    ok = true;
+    return section;
+}
+
+bool VpkWriter::write(const fs::path& dir_path) {
+    auto start_time = std::chrono::steady_clock::now();
+    last_report = VpkWriteReport();
+
+    std::string prefix = dir_path.stem().string();
+    const std::string dir_suffix = "_dir";
+    if (dir_path.extension() != ".vpk" || prefix.size() <= dir_suffix.size() ||
+        prefix.compare(prefix.size() - dir_suffix.size(), dir_suffix.size(), dir_suffix) != 0) {
+        std::cerr << "[ERROR] VPK Writer: Output must be named <name>_dir.vpk: " << dir_path.string() << std::endl;
+        return false;
+    }
+    prefix.erase(prefix.size() - dir_suffix.size());
+
+    std::sort(entries.begin(), entries.end(), [](const PendingEntry& a, const PendingEntry& b) {
+        if (a.extension != b.extension) return a.extension < b.extension;
+        if (a.directory != b.directory) return a.directory < b.directory;
+        return a.stem < b.stem;
+    });
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        const PendingEntry& a = entries[i - 1];
+        const PendingEntry& b = entries[i];
+        if (a.extension == b.extension && a.directory == b.directory && a.stem == b.stem) {
+            std::cerr << "[ERROR] VPK Writer: Duplicate entry " << b.directory << "/" << b.stem << "." << b.extension << std::endl;
+            return false;
+        }
+    }
+
+    Logger::instance().info("VPK Writer: Packing " + std::to_string(entries.size()) + " entries into " +
+                            dir_path.filename().string());
+
+    std::vector<std::string> errors;
+    if (!hash_entries(errors)) {
+        for (const auto& error : errors) {
+            std::cerr << "[ERROR] VPK Writer: " << error << std::endl;
+        }
+        return false;
+    }
+
+    if (!lay_out_volumes()) {
+        return false;
+    }
+
+    std::vector<fs::path> volume_paths;
+    for (size_t v = 0; v < volume_sizes.size(); ++v) {
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "_%03zu.vpk", v);
+        volume_paths.push_back(dir_path.parent_path() / (prefix + suffix));
+    }
+
+    if (!write_volumes(volume_paths)) {
+        return false;
+    }
+
+    std::vector<uint8_t> tree = build_tree();
+    std::vector<uint8_t> archive_md5;
+    if (options.write_md5_sections) {
+        bool hashed = false;
+        archive_md5 = hash_volume_chunks(volume_paths, hashed);
+        if (!hashed) return false;
+    }
+
+    std::vector<uint8_t> dir_file;
+    dir_file.reserve(vpk::V2_HEADER_SIZE + tree.size() + archive_md5.size() + vpk::OTHER_MD5_SECTION_SIZE);
+    put(dir_file, vpk::SIGNATURE);
+    put(dir_file, static_cast<uint32_t>(2));
+    put(dir_file, static_cast<uint32_t>(tree.size()));
+    put(dir_file, static_cast<uint32_t>(0)); // file data section: nothing is embedded
+    put(dir_file, static_cast<uint32_t>(archive_md5.size()));
+    put(dir_file, options.write_md5_sections ? vpk::OTHER_MD5_SECTION_SIZE : 0u);
+    put(dir_file, static_cast<uint32_t>(0)); // signature section
+    dir_file.insert(dir_file.end(), tree.begin(), tree.end());
+    dir_file.insert(dir_file.end(), archive_md5.begin(), archive_md5.end());
+
+    if (options.write_md5_sections) {
+        Md5Digest tree_digest = Md5::digest(tree.data(), tree.size());
+        Md5Digest archive_md5_digest = Md5::digest(archive_md5.data(), archive_md5.size());
+        dir_file.insert(dir_file.end(), tree_digest.begin(), tree_digest.end());
+        dir_file.insert(dir_file.end(), archive_md5_digest.begin(), archive_md5_digest.end());
+
+        // The whole-file digest covers everything before itself
+        Md5Digest file_digest = Md5::digest(dir_file.data(), dir_file.size());
+        dir_file.insert(dir_file.end(), file_digest.begin(), file_digest.end());
+    }
+
+    if (!write_file(dir_path, dir_file)) {
+        std::cerr << "[ERROR] VPK Writer: Failed to write " << dir_path.string() << std::endl;
+        return false;
+    }
+
+    last_report.stale_volumes_removed = remove_stale_volumes(dir_path.parent_path(), prefix, volume_sizes.size());
+
+    last_report.entries = static_cast<uint32_t>(entries.size());
+    last_report.volumes = static_cast<uint32_t>(volume_sizes.size());
+    last_report.bytes_written = dir_file.size();
+    for (uint64_t size : volume_sizes) {
+        last_report.bytes_written += size;
+    }
+    last_report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::ostringstream oss;
+    oss << "VPK Writer: Wrote " << last_report.entries << " entries in " << last_report.volumes << " volumes ("
+        << (last_report.bytes_written / (1024 * 1024)) << " MB, " << last_report.deduplicated_entries
+        << " deduplicated) in " << last_report.seconds << " s";
+    if (last_report.stale_volumes_removed > 0) {
+        oss << ", removed " << last_report.stale_volumes_removed << " stale volumes";
+    }
+    Logger::instance().success(oss.str());
+    return true;
+}
+
+} // namespace unpaker::parsers
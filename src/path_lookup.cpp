@@ -0,0 +1,241 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "path_lookup.hpp"
+#include "ascii.hpp"
+
+namespace unpaker {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+constexpr size_t MIN_SLOTS = 16;
+
+inline bool is_separator(char c) {
+    return c == '/' || c == '\\';
+}
+
+inline bool equals_folded(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (fold_ascii(a[i]) != fold_ascii(b[i])) return false;
+    }
+    return true;
+}
+
+inline uint64_t hash_component(uint64_t hash, std::string_view name, bool separator) {
+    if (separator) {
+        hash ^= '/';
+        hash *= FNV_PRIME;
+    }
+    for (char c : name) {
+        hash ^= fold_ascii(static_cast<uint8_t>(c));
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// FNV-1a leaves the high bits weakly mixed; the table indexes with the low bits and tags with the high ones
+inline uint64_t finalize(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Walks the components of a path from the end, skipping empty and "." components
+class ReverseComponents {
+public:
+    explicit ReverseComponents(std::string_view path) : path(path), end(path.size()) {}
+
+    bool next(std::string_view& component) {
+        while (end > 0) {
+            size_t begin = end;
+            while (begin > 0 && !is_separator(path[begin - 1])) {
+                --begin;
+            }
+            component = path.substr(begin, end - begin);
+            end = begin > 0 ? begin - 1 : 0;
+            if (!component.empty() && component != ".") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::string_view path;
+    size_t end;
+};
+
+} // namespace
+
+uint64_t PathLookup::hash_path(std::string_view path) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    bool first = true;
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t next = pos;
+        while (next < path.size() && !is_separator(path[next])) {
+            ++next;
+        }
+
+        std::string_view component = path.substr(pos, next - pos);
+        if (!component.empty() && component != ".") {
+            hash = hash_component(hash, component, !first);
+            first = false;
+        }
+        pos = next + 1;
+    }
+    return finalize(hash);
+}
+
+std::vector<uint64_t> PathLookup::hash_entries(const ArchiveIndex& index) {
+    // A directory's hash extends its parent's, and parents always have the lower DirId
+    std::vector<uint64_t> dir_hashes(index.directory_count());
+    dir_hashes[ROOT_DIR_ID] = FNV_OFFSET_BASIS;
+    for (DirId dir = 1; dir < index.directory_count(); ++dir) {
+        DirId parent = index.directory_parent(dir);
+        dir_hashes[dir] = hash_component(dir_hashes[parent], index.directory_name(dir), parent != ROOT_DIR_ID);
+    }
+
+    std::vector<uint64_t> hashes(index.entry_count());
+    for (DirId dir = 0; dir < index.directory_count(); ++dir) {
+        EntryId first = index.first_file(dir);
+        for (EntryId id = first; id < first + index.file_count(dir); ++id) {
+            hashes[id] = finalize(hash_component(dir_hashes[dir], index.name(id), dir != ROOT_DIR_ID));
+        }
+    }
+    return hashes;
+}
+
+void PathLookup::build(const ArchiveIndex& index) {
+    clear();
+
+    size_t capacity = MIN_SLOTS;
+    while (capacity < index.entry_count() * 2) {
+        capacity <<= 1;
+    }
+    slots.assign(capacity, Slot{0, INVALID_ENTRY_ID});
+    mask = capacity - 1;
+
+    std::vector<uint64_t> hashes = hash_entries(index);
+
+    for (DirId dir = 0; dir < index.directory_count(); ++dir) {
+        EntryId first = index.first_file(dir);
+        for (EntryId id = first; id < first + index.file_count(dir); ++id) {
+            uint64_t hash = hashes[id];
+            uint32_t tag = static_cast<uint32_t>(hash >> 32);
+            size_t pos = static_cast<size_t>(hash) & mask;
+
+            bool collided = false;
+            while (slots[pos].id != INVALID_ENTRY_ID) {
+                // Tags only repeat for folded duplicates or a true 64-bit clash, so building the path here is rare
+                if (slots[pos].tag == tag && matches(index, slots[pos].id, index.path(id))) {
+                    path_collisions.push_back({slots[pos].id, id});
+                    collided = true;
+                    break;
+                }
+                pos = (pos + 1) & mask;
+            }
+
+            if (!collided) {
+                slots[pos] = Slot{tag, id};
+            }
+        }
+    }
+}
+
+void PathLookup::clear() {
+    slots.clear();
+    mask = 0;
+    path_collisions.clear();
+}
+
+EntryId PathLookup::find(const ArchiveIndex& index, std::string_view path) const {
+    if (slots.empty()) {
+        return INVALID_ENTRY_ID;
+    }
+
+    uint64_t hash = hash_path(path);
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t pos = static_cast<size_t>(hash) & mask;
+
+    while (slots[pos].id != INVALID_ENTRY_ID) {
+        if (slots[pos].tag == tag && matches(index, slots[pos].id, path)) {
+            return slots[pos].id;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return INVALID_ENTRY_ID;
+}
+
+DirId PathLookup::find_directory(const ArchiveIndex& index, std::string_view path) {
+    DirId current = ROOT_DIR_ID;
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t next = pos;
+        while (next < path.size() && !is_separator(path[next])) {
+            ++next;
+        }
+
+        std::string_view component = path.substr(pos, next - pos);
+        pos = next + 1;
+        if (component.empty() || component == ".") {
+            continue;
+        }
+
+        DirId first = index.first_subdirectory(current);
+        DirId found = INVALID_DIR_ID;
+        for (DirId child = first; child < first + index.subdirectory_count(current); ++child) {
+            if (equals_folded(component, index.directory_name(child))) {
+                found = child;
+                break;
+            }
+        }
+        if (found == INVALID_DIR_ID) {
+            return INVALID_DIR_ID;
+        }
+        current = found;
+    }
+    return current;
+}
+
+size_t PathLookup::memory_usage() const {
+    return slots.capacity() * sizeof(Slot) + path_collisions.capacity() * sizeof(PathCollision);
+}
+
+bool PathLookup::matches(const ArchiveIndex& index, EntryId id, std::string_view path) {
+    ReverseComponents components(path);
+    std::string_view component;
+
+    if (!components.next(component) || !equals_folded(component, index.name(id))) {
+        return false;
+    }
+
+    for (DirId dir = index.directory_of(id); dir != ROOT_DIR_ID; dir = index.directory_parent(dir)) {
+        if (!components.next(component) || !equals_folded(component, index.directory_name(dir))) {
+            return false;
+        }
+    }
+
+    return !components.next(component);
+}
+
+bool PathLookup::same_path(std::string_view a, std::string_view b) {
+    ReverseComponents left(a);
+    ReverseComponents right(b);
+    std::string_view x;
+    std::string_view y;
+
+    while (left.next(x)) {
+        if (!right.next(y) || !equals_folded(x, y)) {
+            return false;
+        }
+    }
+    return !right.next(y);
+}
+
+} // namespace unpaker
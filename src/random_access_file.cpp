@@ -0,0 +1,201 @@
+﻿// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "random_access_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace unpaker {
+
+#ifndef _WIN32
+namespace {
+// Linux UIO_MAXIOV; larger batches are split across several preadv calls
+constexpr size_t MAX_IO_SLICES = 1024;
+}
+#endif
+
+RandomAccessFile::~RandomAccessFile() {
+    close();
+}
+
+bool RandomAccessFile::open(const fs::path& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.wstring().c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(handle, &file_size)) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    handle_ = handle;
+    size_ = static_cast<uint64_t>(file_size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    size_ = static_cast<uint64_t>(st.st_size);
+#endif
+
+    path_ = path;
+    return true;
+}
+
+void RandomAccessFile::close() {
+#ifdef _WIN32
+    if (handle_) {
+        CloseHandle(static_cast<HANDLE>(handle_));
+        handle_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+    size_ = 0;
+}
+
+bool RandomAccessFile::is_open() const {
+#ifdef _WIN32
+    return handle_ != nullptr;
+#else
+    return fd_ >= 0;
+#endif
+}
+
+size_t RandomAccessFile::read_at(uint64_t offset, void* buffer, size_t length) const {
+    if (!is_open()) return 0;
+
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    size_t total = 0;
+
+    while (total < length) {
+#ifdef _WIN32
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(length - total, 0x40000000));
+        OVERLAPPED overlapped = {};
+        uint64_t position = offset + total;
+        overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFFu);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytes_read = 0;
+        if (!ReadFile(static_cast<HANDLE>(handle_), out + total, chunk, &bytes_read, &overlapped) || bytes_read == 0) {
+            break;
+        }
+#else
+        size_t chunk = std::min<size_t>(length - total, 0x40000000);
+        ssize_t bytes_read = ::pread(fd_, out + total, chunk, static_cast<off_t>(offset + total));
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read <= 0) {
+            break;
+        }
+#endif
+        total += static_cast<size_t>(bytes_read);
+    }
+
+    return total;
+}
+
+size_t RandomAccessFile::read_vectored(uint64_t offset, const IoSlice* slices, size_t count) const {
+    if (!is_open()) return 0;
+
+#ifdef _WIN32
+    // ReadFileScatter needs unbuffered page-aligned I/O, so read the range once and scatter it here
+    size_t total_length = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total_length += slices[i].length;
+    }
+
+    std::vector<uint8_t> span(total_length);
+    size_t bytes_read = read_at(offset, span.data(), total_length);
+
+    size_t copied = 0;
+    for (size_t i = 0; i < count && copied < bytes_read; ++i) {
+        size_t chunk = std::min(slices[i].length, bytes_read - copied);
+        std::memcpy(slices[i].data, span.data() + copied, chunk);
+        copied += chunk;
+    }
+    return bytes_read;
+#else
+    std::vector<iovec> iov;
+    iov.reserve(std::min(count, MAX_IO_SLICES));
+
+    size_t total = 0;
+    size_t slice = 0;
+    size_t slice_offset = 0;
+
+    for (;;) {
+        while (slice < count && slice_offset == slices[slice].length) {
+            ++slice;
+            slice_offset = 0;
+        }
+        if (slice >= count) break;
+
+        iov.clear();
+        for (size_t i = slice; i < count && iov.size() < MAX_IO_SLICES; ++i) {
+            size_t skip = i == slice ? slice_offset : 0;
+            iov.push_back({static_cast<uint8_t*>(slices[i].data) + skip, slices[i].length - skip});
+        }
+
+        ssize_t bytes_read = ::preadv(fd_, iov.data(), static_cast<int>(iov.size()),
+                                      static_cast<off_t>(offset + total));
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(bytes_read);
+
+        // Advance past what was filled; a short read resumes mid-slice
+        size_t remaining = static_cast<size_t>(bytes_read);
+        while (remaining > 0) {
+            size_t left = slices[slice].length - slice_offset;
+            if (remaining < left) {
+                slice_offset += remaining;
+                break;
+            }
+            remaining -= left;
+            ++slice;
+            slice_offset = 0;
+        }
+    }
+
+    return total;
+#endif
+}
+
+} // namespace unpaker
@@ -0,0 +1,517 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+#include "text_index.hpp"
+#include "ascii.hpp"
+#include "index_cache.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include "path_lookup.hpp"
+#include "text_assets.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+namespace unpaker {
+
+namespace {
+
+constexpr uint32_t TEXT_INDEX_MAGIC = 0x544B5055; // "UPKT"
+constexpr uint32_t TEXT_INDEX_VERSION = 2;
+
+// Documents handed to one worker at a time while building
+constexpr size_t BUILD_CHUNK_DOCUMENTS = 256;
+// One bit per possible trigram; a worker marks what it has seen in the current document
+constexpr size_t TRIGRAM_SPACE = 1u << 24;
+
+struct ArchiveStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+bool stamp_archive(const fs::path& archive_path, ArchiveStamp& stamp) {
+    std::error_code ec;
+    stamp.size = fs::file_size(archive_path, ec);
+    if (ec) return false;
+    auto mtime = fs::last_write_time(archive_path, ec);
+    if (ec) return false;
+    stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    size_t pos = out.size();
+    out.resize(pos + sizeof(T));
+    std::memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+template <typename T>
+void put_column(std::vector<uint8_t>& out, const std::vector<T>& column) {
+    put(out, static_cast<uint64_t>(column.size()));
+    size_t pos = out.size();
+    out.resize(pos + column.size() * sizeof(T));
+    if (!column.empty()) {
+        std::memcpy(out.data() + pos, column.data(), column.size() * sizeof(T));
+    }
+}
+
+class Reader {
+public:
+    Reader(const uint8_t* data, uint64_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (pos + sizeof(T) > size) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool get_column(std::vector<T>& column) {
+        uint64_t count = 0;
+        if (!get(count) || count > (size - pos) / sizeof(T)) return false;
+        column.resize(static_cast<size_t>(count));
+        if (count > 0) {
+            std::memcpy(column.data(), data + pos, static_cast<size_t>(count) * sizeof(T));
+        }
+        pos += count * sizeof(T);
+        return true;
+    }
+
+    bool at_end() const { return pos == size; }
+
+private:
+    const uint8_t* data;
+    uint64_t size;
+    uint64_t pos = 0;
+};
+
+// Collects the distinct trigrams of one document at a time
+class TrigramCollector {
+public:
+    TrigramCollector() : seen(TRIGRAM_SPACE / 64, 0) {}
+
+    void add(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            window = ((window << 8) | fold_ascii(data[i])) & (TRIGRAM_SPACE - 1);
+            if (++filled < 3) continue;
+            uint64_t& word = seen[window >> 6];
+            uint64_t bit = uint64_t(1) << (window & 63);
+            if (!(word & bit)) {
+                word |= bit;
+                keys.push_back(window);
+            }
+        }
+    }
+
+    // Sorted keys of the document; resets for the next one
+    std::vector<uint32_t> finish() {
+        for (uint32_t key : keys) {
+            seen[key >> 6] = 0;
+        }
+        std::vector<uint32_t> result;
+        result.swap(keys);
+        std::sort(result.begin(), result.end());
+        window = 0;
+        filled = 0;
+        return result;
+    }
+
+private:
+    std::vector<uint64_t> seen;
+    std::vector<uint32_t> keys;
+    uint32_t window = 0;
+    size_t filled = 0;
+};
+
+} // namespace
+
+TextIndex::TextIndex() : cache_dir(IndexCache::default_cache_dir()) {
+}
+
+TextIndex::TextIndex(const fs::path& cache_dir) : cache_dir(cache_dir) {
+}
+
+fs::path TextIndex::get_index_file(const fs::path& archive_path) const {
+    fs::path file = IndexCache(cache_dir).get_cache_file(archive_path);
+    if (!file.empty()) {
+        file.replace_extension(".tri");
+    }
+    return file;
+}
+
+bool TextIndex::open(const PakParser& parser, uint32_t thread_count) {
+    const fs::path& archive_path = parser.get_archive_path();
+    ArchiveStamp stamp;
+    bool stamped = stamp_archive(archive_path, stamp);
+
+    TextIndex stored(cache_dir);
+    if (stamped && stored.load(archive_path)) {
+        if (stored.archive_size == stamp.size && stored.archive_mtime == stamp.mtime) {
+            TextIndexStats previous_stats = statistics;
+            *this = std::move(stored);
+            statistics = previous_stats;
+            statistics.documents = static_cast<uint32_t>(document_entries.size());
+            statistics.trigrams = trigram_keys.size();
+            statistics.postings = postings.size();
+            statistics.loaded = true;
+            LOG_DEBUG("TextIndex: Using stored index for " + archive_path.string());
+            return true;
+        }
+        build(parser, thread_count, &stored);
+    } else {
+        build(parser, thread_count);
+    }
+
+    if (stamped) {
+        store(archive_path);
+    }
+    return statistics.documents > statistics.failed || statistics.documents == 0;
+}
+
+void TextIndex::build(const PakParser& parser, uint32_t thread_count, const TextIndex* previous) {
+    auto start_time = std::chrono::steady_clock::now();
+    const ArchiveIndex& index = parser.get_index();
+
+    TextIndex built(cache_dir);
+    built.has_checksums = parser.has_entry_checksums();
+    ArchiveStamp stamp;
+    if (stamp_archive(parser.get_archive_path(), stamp)) {
+        built.archive_size = stamp.size;
+        built.archive_mtime = stamp.mtime;
+    }
+
+    for (EntryId id = 0; id < index.entry_count(); ++id) {
+        if (is_text_asset(index.name(id))) {
+            built.document_entries.push_back(id);
+            built.document_sizes.push_back(index.size(id));
+            built.document_crcs.push_back(index.crc(id));
+            built.document_path_hashes.push_back(PathLookup::hash_path(index.path(id)));
+        }
+    }
+    const size_t document_count = built.document_entries.size();
+
+    std::vector<std::vector<uint32_t>> trigrams(document_count);
+    std::vector<uint8_t> done(document_count, 0);
+    TextIndexStats stats;
+
+    // Without CRCs an entry rewritten in place looks unchanged, so nothing is carried over
+    if (previous && previous->has_checksums && built.has_checksums) {
+        std::vector<uint8_t> previous_failed(previous->document_entries.size(), 0);
+        for (uint32_t d : previous->failed_documents) {
+            previous_failed[d] = 1;
+        }
+
+        std::unordered_map<uint64_t, uint32_t> previous_by_path;
+        for (uint32_t d = 0; d < previous->document_path_hashes.size(); ++d) {
+            if (!previous_failed[d]) {
+                previous_by_path.emplace(previous->document_path_hashes[d], d);
+            }
+        }
+
+        std::vector<std::vector<uint32_t>> previous_trigrams = previous->document_trigrams();
+        for (size_t d = 0; d < document_count; ++d) {
+            auto it = previous_by_path.find(built.document_path_hashes[d]);
+            if (it == previous_by_path.end()) continue;
+            if (previous->document_sizes[it->second] == built.document_sizes[d] &&
+                previous->document_crcs[it->second] == built.document_crcs[d]) {
+                trigrams[d] = std::move(previous_trigrams[it->second]);
+                done[d] = 1;
+                stats.reused++;
+            }
+        }
+    }
+
+    std::vector<size_t> pending;
+    for (size_t d = 0; d < document_count; ++d) {
+        if (!done[d]) pending.push_back(d);
+    }
+
+    size_t chunk_count = (pending.size() + BUILD_CHUNK_DOCUMENTS - 1) / BUILD_CHUNK_DOCUMENTS;
+    std::vector<uint64_t> chunk_bytes(chunk_count, 0);
+    std::vector<uint32_t> chunk_failed(chunk_count, 0);
+    std::vector<uint8_t> failed(document_count, 0);
+
+    auto index_chunk = [&](size_t c) {
+        TrigramCollector collector;
+        size_t end = std::min(pending.size(), (c + 1) * BUILD_CHUNK_DOCUMENTS);
+        for (size_t p = c * BUILD_CHUNK_DOCUMENTS; p < end; ++p) {
+            size_t d = pending[p];
+            EntryStream stream = parser.open_entry(built.document_entries[d]);
+            bool complete = stream.is_open() && stream.copy_to([&](const uint8_t* data, size_t length) {
+                collector.add(data, length);
+                chunk_bytes[c] += length;
+                return true;
+            });
+            trigrams[d] = collector.finish();
+            // A partial trigram set would hide the entry from literals in its unread part
+            if (!complete) {
+                trigrams[d].clear();
+                failed[d] = 1;
+                chunk_failed[c]++;
+            }
+        }
+    };
+
+    ThreadPool::run(chunk_count, thread_count, index_chunk);
+
+    for (size_t c = 0; c < chunk_count; ++c) {
+        stats.bytes_read += chunk_bytes[c];
+        stats.failed += chunk_failed[c];
+    }
+    stats.indexed = static_cast<uint32_t>(pending.size());
+    for (uint32_t d = 0; d < document_count; ++d) {
+        if (failed[d]) built.failed_documents.push_back(d);
+    }
+
+    // Invert into posting lists; documents are visited in order, so every list comes out sorted
+    std::vector<uint64_t> pairs;
+    size_t total = 0;
+    for (const auto& keys : trigrams) total += keys.size();
+    pairs.reserve(total);
+    for (uint32_t d = 0; d < trigrams.size(); ++d) {
+        for (uint32_t key : trigrams[d]) {
+            pairs.push_back((static_cast<uint64_t>(key) << 32) | d);
+        }
+        std::vector<uint32_t>().swap(trigrams[d]);
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    built.postings.reserve(pairs.size());
+    for (uint64_t pair : pairs) {
+        uint32_t key = static_cast<uint32_t>(pair >> 32);
+        if (built.trigram_keys.empty() || built.trigram_keys.back() != key) {
+            built.trigram_keys.push_back(key);
+            built.posting_starts.push_back(static_cast<uint32_t>(built.postings.size()));
+        }
+        built.postings.push_back(static_cast<uint32_t>(pair));
+    }
+    built.posting_starts.push_back(static_cast<uint32_t>(built.postings.size()));
+
+    stats.documents = static_cast<uint32_t>(document_count);
+    stats.trigrams = built.trigram_keys.size();
+    stats.postings = built.postings.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    *this = std::move(built);
+    statistics = stats;
+
+    Logger::instance().info("Text index: " + std::to_string(stats.documents) + " entries (" +
+                            std::to_string(stats.reused) + " reused, " + std::to_string(stats.indexed) +
+                            " read), " + std::to_string(stats.trigrams) + " trigrams in " +
+                            std::to_string(stats.seconds) + "s");
+}
+
+std::vector<std::vector<uint32_t>> TextIndex::document_trigrams() const {
+    std::vector<std::vector<uint32_t>> result(document_entries.size());
+    for (size_t t = 0; t < trigram_keys.size(); ++t) {
+        for (uint32_t p = posting_starts[t]; p < posting_starts[t + 1]; ++p) {
+            result[postings[p]].push_back(trigram_keys[t]);
+        }
+    }
+    return result;
+}
+
+const uint32_t* TextIndex::find_postings(uint32_t trigram, size_t& count) const {
+    auto it = std::lower_bound(trigram_keys.begin(), trigram_keys.end(), trigram);
+    if (it == trigram_keys.end() || *it != trigram) {
+        count = 0;
+        return nullptr;
+    }
+    size_t t = static_cast<size_t>(it - trigram_keys.begin());
+    count = posting_starts[t + 1] - posting_starts[t];
+    return postings.data() + posting_starts[t];
+}
+
+std::vector<EntryId> TextIndex::candidates(std::string_view literal) const {
+    std::vector<EntryId> result;
+    if (literal.size() < 3) {
+        return document_entries;
+    }
+
+    std::vector<uint32_t> keys;
+    for (size_t i = 0; i + 3 <= literal.size(); ++i) {
+        keys.push_back((static_cast<uint32_t>(fold_ascii(static_cast<uint8_t>(literal[i]))) << 16) |
+                       (static_cast<uint32_t>(fold_ascii(static_cast<uint8_t>(literal[i + 1]))) << 8) |
+                       fold_ascii(static_cast<uint8_t>(literal[i + 2])));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Intersect starting from the shortest list
+    std::vector<std::pair<const uint32_t*, size_t>> lists;
+    bool missing = false;
+    for (uint32_t key : keys) {
+        size_t count = 0;
+        const uint32_t* list = find_postings(key, count);
+        if (count == 0) {
+            missing = true;
+            break;
+        }
+        lists.push_back({list, count});
+    }
+
+    std::vector<uint32_t> matched;
+    std::vector<uint32_t> next;
+    if (!missing) {
+        std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+        matched.assign(lists[0].first, lists[0].first + lists[0].second);
+        for (size_t l = 1; l < lists.size() && !matched.empty(); ++l) {
+            next.clear();
+            std::set_intersection(matched.begin(), matched.end(), lists[l].first, lists[l].first + lists[l].second,
+                                  std::back_inserter(next));
+            matched.swap(next);
+        }
+    }
+
+    // Entries that were never read in full may hold the literal anywhere
+    if (!failed_documents.empty()) {
+        next.clear();
+        std::set_union(matched.begin(), matched.end(), failed_documents.begin(), failed_documents.end(),
+                       std::back_inserter(next));
+        matched.swap(next);
+    }
+
+    for (uint32_t d : matched) result.push_back(document_entries[d]);
+    return result;
+}
+
+std::vector<EntryId> TextIndex::candidates(const std::vector<std::string>& literals) const {
+    std::vector<EntryId> result;
+    for (const auto& literal : literals) {
+        std::vector<EntryId> found = candidates(literal);
+        std::vector<EntryId> merged;
+        std::set_union(result.begin(), result.end(), found.begin(), found.end(), std::back_inserter(merged));
+        result.swap(merged);
+    }
+    return result;
+}
+
+SearchResult TextIndex::search(const PakParser& parser, const SearchOptions& options) const {
+    // A regex alone names no literal to narrow by, so every text entry is a candidate
+    std::vector<EntryId> entries = options.literals.empty() ? candidates(std::string_view()) : candidates(options.literals);
+    return ContentSearch::search(parser, entries, options);
+}
+
+bool TextIndex::load(const fs::path& archive_path) {
+    fs::path index_file = get_index_file(archive_path);
+    std::error_code ec;
+    if (index_file.empty() || !fs::exists(index_file, ec)) {
+        return false;
+    }
+
+    MappedFile mapping;
+    if (!mapping.open(index_file) || !mapping.data()) {
+        return false;
+    }
+
+    Reader reader(mapping.data(), mapping.size());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.get(magic) || !reader.get(version) || magic != TEXT_INDEX_MAGIC || version != TEXT_INDEX_VERSION) {
+        LOG_DEBUG("TextIndex: Ignoring index file with unknown layout: " + index_file.string());
+        return false;
+    }
+
+    TextIndex loaded(cache_dir);
+    uint8_t checksums = 0;
+    bool valid = reader.get(loaded.archive_size) && reader.get(loaded.archive_mtime) && reader.get(checksums) &&
+                 reader.get_column(loaded.document_entries) && reader.get_column(loaded.document_sizes) &&
+                 reader.get_column(loaded.document_crcs) && reader.get_column(loaded.document_path_hashes) &&
+                 reader.get_column(loaded.failed_documents) && reader.get_column(loaded.trigram_keys) &&
+                 reader.get_column(loaded.posting_starts) && reader.get_column(loaded.postings) && reader.at_end();
+
+    // Check the lists point where they should before any query relies on them
+    if (valid) {
+        size_t rows = loaded.document_entries.size();
+        valid = loaded.document_sizes.size() == rows && loaded.document_crcs.size() == rows &&
+                loaded.document_path_hashes.size() == rows &&
+                std::is_sorted(loaded.failed_documents.begin(), loaded.failed_documents.end()) &&
+                std::all_of(loaded.failed_documents.begin(), loaded.failed_documents.end(),
+                            [&](uint32_t d) { return d < rows; }) &&
+                loaded.posting_starts.size() == loaded.trigram_keys.size() + 1 &&
+                loaded.posting_starts.front() == 0 && loaded.posting_starts.back() == loaded.postings.size() &&
+                std::is_sorted(loaded.posting_starts.begin(), loaded.posting_starts.end()) &&
+                std::all_of(loaded.postings.begin(), loaded.postings.end(),
+                            [&](uint32_t d) { return d < rows; });
+    }
+    if (!valid) {
+        std::cerr << "[WARNING] TextIndex: Corrupt index file, ignoring: " << index_file.string() << std::endl;
+        return false;
+    }
+
+    loaded.has_checksums = checksums != 0;
+    loaded.statistics = statistics;
+    *this = std::move(loaded);
+    return true;
+}
+
+bool TextIndex::store(const fs::path& archive_path) const {
+    fs::path index_file = get_index_file(archive_path);
+    if (index_file.empty()) return false;
+
+    std::vector<uint8_t> buffer;
+    put(buffer, TEXT_INDEX_MAGIC);
+    put(buffer, TEXT_INDEX_VERSION);
+    put(buffer, archive_size);
+    put(buffer, archive_mtime);
+    put(buffer, static_cast<uint8_t>(has_checksums ? 1 : 0));
+    put_column(buffer, document_entries);
+    put_column(buffer, document_sizes);
+    put_column(buffer, document_crcs);
+    put_column(buffer, document_path_hashes);
+    put_column(buffer, failed_documents);
+    put_column(buffer, trigram_keys);
+    put_column(buffer, posting_starts);
+    put_column(buffer, postings);
+
+    try {
+        fs::create_directories(cache_dir);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "[WARNING] TextIndex: Failed to store index: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Same as the index cache: write beside the final name and rename over it
+    fs::path temp_file = IndexCache::temp_file_for(index_file);
+    bool written = false;
+    {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[WARNING] TextIndex: Failed to open index file for writing: "
+                      << temp_file.string() << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        written = out.good();
+    }
+
+    std::error_code ec;
+    if (!written) {
+        std::cerr << "[WARNING] TextIndex: Failed to write index file: " << temp_file.string() << std::endl;
+    } else {
+        fs::rename(temp_file, index_file, ec);
+        if (ec) {
+            std::cerr << "[WARNING] TextIndex: Failed to store index: " << ec.message() << std::endl;
+        }
+    }
+    if (!written || ec) {
+        std::error_code remove_ec;
+        fs::remove(temp_file, remove_ec);
+        return false;
+    }
+
+    DEBUG_COUT("[DEBUG] TextIndex: Stored " << document_entries.size() << " entries (" << buffer.size()
+                                            << " bytes) in " << index_file.string() << std::endl);
+    return true;
+}
+
+} // namespace unpaker
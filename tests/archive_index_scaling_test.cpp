@@ -0,0 +1,125 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+// Builds indexes of 10k to 1M entries over a fixed 3,600-directory layout, checks the resulting
+// tree, and fails if the time per entry grows with the entry count. The bound is loose on purpose:
+// a quadratic builder is off by two orders of magnitude at 1M entries, timer noise is not.
+
+#include "archive_index.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace unpaker;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+constexpr size_t TOP_DIRS = 60;
+constexpr size_t SUB_DIRS = 60;
+constexpr size_t LEAF_DIRS = TOP_DIRS * SUB_DIRS;
+const char* const EXTENSIONS[] = {"vmt", "vtf", "mdl", "wav", "txt"};
+constexpr size_t EXTENSION_COUNT = sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]);
+
+// Parser order: grouped by extension, then by directory, as a VPK tree lists them
+ArchiveIndex build(size_t entries) {
+    ArchiveIndexBuilder builder;
+    builder.reserve(entries);
+
+    const size_t per_group = (entries + EXTENSION_COUNT * LEAF_DIRS - 1) / (EXTENSION_COUNT * LEAF_DIRS);
+    std::string dir_path;
+    std::string stem;
+    size_t added = 0;
+    for (size_t e = 0; e < EXTENSION_COUNT && added < entries; ++e) {
+        for (size_t d = 0; d < LEAF_DIRS && added < entries; ++d) {
+            dir_path = "game/t" + std::to_string(d / SUB_DIRS) + "/s" + std::to_string(d % SUB_DIRS);
+            for (size_t f = 0; f < per_group && added < entries; ++f, ++added) {
+                stem = "file" + std::to_string(f);
+                EntryRecord record;
+                record.offset = added;
+                record.size = static_cast<uint32_t>(added);
+                builder.add(dir_path, stem, EXTENSIONS[e], record);
+            }
+        }
+    }
+    return builder.finish();
+}
+
+double seconds_per_entry(size_t entries, ArchiveIndex& index) {
+    auto start = std::chrono::steady_clock::now();
+    index = build(entries);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(entries);
+}
+
+void check_tree(const ArchiveIndex& index, size_t entries) {
+    const std::string label = std::to_string(entries) + " entries: ";
+    check(index.entry_count() == entries, label + "entry count");
+
+    // Root, "game", the t* level and the s* level; every size tested fills all leaf directories
+    check(index.directory_count() == 2 + TOP_DIRS + LEAF_DIRS, label + "directory count");
+
+    size_t files = 0;
+    bool ranges_match = true;
+    for (DirId d = 0; d < index.directory_count(); ++d) {
+        files += index.file_count(d);
+        for (uint32_t i = 0; i < index.file_count(d); ++i) {
+            ranges_match &= index.directory_of(index.first_file(d) + i) == d;
+        }
+        for (uint32_t i = 0; i < index.subdirectory_count(d); ++i) {
+            ranges_match &= index.directory_parent(index.first_subdirectory(d) + i) == d;
+        }
+    }
+    check(files == entries, label + "every entry sits in one directory");
+    check(ranges_match, label + "file and subdirectory ranges point back at their directory");
+
+    // Entry offsets record the insertion order, so the path can be rebuilt and compared
+    const size_t per_group = (entries + EXTENSION_COUNT * LEAF_DIRS - 1) / (EXTENSION_COUNT * LEAF_DIRS);
+    bool paths_match = true;
+    for (EntryId id = 0; id < index.entry_count(); id += 997) {
+        size_t n = static_cast<size_t>(index.offset(id));
+        size_t group = n / per_group;
+        size_t d = group % LEAF_DIRS;
+        std::string expected = "game/t" + std::to_string(d / SUB_DIRS) + "/s" + std::to_string(d % SUB_DIRS) +
+                               "/file" + std::to_string(n % per_group) + "." + EXTENSIONS[group / LEAF_DIRS];
+        paths_match &= index.path(id) == expected && index.size(id) == n;
+    }
+    check(paths_match, label + "sampled paths and records");
+}
+
+} // namespace
+
+int main() {
+    const size_t sizes[] = {10000, 100000, 300000, 1000000};
+
+    // Warm the allocator before timing the smallest run
+    ArchiveIndex index = build(10000);
+
+    double per_entry[4] = {};
+    for (size_t i = 0; i < 4; ++i) {
+        per_entry[i] = seconds_per_entry(sizes[i], index);
+        check_tree(index, sizes[i]);
+        std::cout << sizes[i] << " entries: " << per_entry[i] * 1e9 << " ns/entry" << std::endl;
+    }
+
+    // 100x the entries may cost at most 4x the time per entry
+    check(per_entry[3] < per_entry[0] * 4.0, "build time per entry stays roughly constant from 10k to 1M entries");
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "ArchiveIndexBuilder scaling check passed" << std::endl;
+    return 0;
+}
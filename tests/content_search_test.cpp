@@ -0,0 +1,82 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+// ContentSearch reads entries in 1 MiB pieces; a literal must be found wherever it falls
+// relative to a piece boundary, including in text with no line ends to align on.
+
+#include "content_search.hpp"
+#include "pak_parser.hpp"
+#include "vpk_writer.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+constexpr uint64_t MIB = 1024 * 1024;
+const std::string NEEDLE = "NEEDLE";
+
+} // namespace
+
+int main() {
+    fs::path dir = fs::temp_directory_path() / "unpaker_content_search";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+
+    // One newline-free entry per position, each holding the literal exactly once
+    std::vector<uint64_t> positions = {MIB - 12, MIB - 8, MIB - 6, MIB - 5, MIB - 3, MIB - 1,
+                                       MIB, MIB + 1, 2 * MIB - 8, 2 * MIB - 2};
+    unpaker::parsers::VpkWriter writer;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        std::vector<uint8_t> data(2 * MIB + MIB / 2, 'x');
+        std::copy(NEEDLE.begin(), NEEDLE.end(), data.begin() + static_cast<std::ptrdiff_t>(positions[i]));
+        writer.add_data("blob/entry" + std::to_string(i) + ".bin", std::move(data));
+    }
+    fs::path dir_file = dir / "search_dir.vpk";
+    check(writer.write(dir_file), "write archive");
+
+    unpaker::PakParser parser(dir_file);
+    parser.set_index_cache_enabled(false);
+    check(parser.parse(), "parse archive");
+
+    for (bool ignore_case : {false, true}) {
+        unpaker::SearchOptions options;
+        options.literals = {ignore_case ? std::string("needle") : NEEDLE};
+        options.ignore_case = ignore_case;
+        unpaker::SearchResult result = unpaker::ContentSearch::search(parser, options);
+
+        std::string mode = ignore_case ? " (ignoring case)" : "";
+        check(result.matches.size() == positions.size(), "one match per entry" + mode);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            unpaker::EntryId id = parser.find("blob/entry" + std::to_string(i) + ".bin");
+            bool found = false;
+            for (const auto& match : result.matches) {
+                found = found || (match.entry == id && match.offset == positions[i]);
+            }
+            check(found, "literal at offset " + std::to_string(positions[i]) + mode);
+        }
+    }
+
+    fs::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Content search boundaries passed" << std::endl;
+    return 0;
+}
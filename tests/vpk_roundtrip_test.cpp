@@ -0,0 +1,136 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+// Packs entries with VpkWriter and reads them back through PakParser: contents, CRCs and the
+// v2 MD5 sections must all survive the round trip.
+
+#include "pak_parser.hpp"
+#include "crc32.hpp"
+#include "vpk_writer.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+std::vector<uint8_t> pattern(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = seed * 2654435761u + 1;
+    for (auto& byte : data) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<uint8_t>(state >> 16);
+    }
+    return data;
+}
+
+struct Sample {
+    std::string path;
+    std::vector<uint8_t> data;
+    uint32_t preload;
+};
+
+// Rewriting a set with fewer volumes must delete the higher-numbered volumes of the old one
+void check_rebuild(const fs::path& dir) {
+    fs::path dir_file = dir / "pak02_dir.vpk";
+    unpaker::parsers::VpkWriterOptions options;
+    options.max_volume_size = 1000;
+
+    unpaker::parsers::VpkWriter large(options);
+    for (int i = 0; i < 4; ++i) {
+        large.add_data("data/part" + std::to_string(i) + ".bin", pattern(900, static_cast<uint32_t>(i)));
+    }
+    check(large.write(dir_file) && large.report().volumes == 4, "write four-volume set");
+
+    unpaker::parsers::VpkWriter small(options);
+    small.add_data("data/part0.bin", pattern(900, 9));
+    check(small.write(dir_file), "rewrite as one volume");
+    check(small.report().stale_volumes_removed == 3, "stale volumes reported");
+    check(fs::exists(dir / "pak02_000.vpk") && !fs::exists(dir / "pak02_001.vpk") &&
+          !fs::exists(dir / "pak02_003.vpk"), "stale volumes deleted");
+
+    unpaker::PakParser parser(dir_file);
+    parser.set_index_cache_enabled(false);
+    std::vector<uint8_t> data;
+    check(parser.parse() && parser.extract_entry(parser.find("data/part0.bin"), data) && data == pattern(900, 9),
+          "rebuilt set reads back");
+}
+
+} // namespace
+
+int main() {
+    fs::path dir = fs::temp_directory_path() / "unpaker_vpk_roundtrip";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+
+    std::vector<Sample> samples = {
+        {"scripts/items.txt", pattern(1000, 1), 0},
+        {"scripts/copy_of_items.txt", pattern(1000, 1), 0},
+        {"materials/models/hero.vmt", pattern(300, 2), 64},
+        {"materials/models/hero.vtf", pattern(70000, 3), 0},
+        {"sound/ambient/wind.wav", pattern(150000, 4), 0},
+        {"empty.cfg", {}, 0},
+        {"readme", pattern(10, 5), 10},
+    };
+
+    unpaker::parsers::VpkWriterOptions options;
+    options.max_volume_size = 100000;
+    options.md5_chunk_size = 4096;
+    options.thread_count = 2;
+
+    unpaker::parsers::VpkWriter writer(options);
+    for (const auto& sample : samples) {
+        check(writer.add_data(sample.path, sample.data, sample.preload), "add " + sample.path);
+    }
+
+    fs::path dir_file = dir / "pak01_dir.vpk";
+    check(writer.write(dir_file), "write archive");
+    check(writer.report().volumes > 1, "entries spread over several volumes");
+    check(writer.report().deduplicated_entries == 1, "identical entry deduplicated");
+
+    unpaker::PakParser parser(dir_file);
+    parser.set_index_cache_enabled(false);
+    check(parser.parse(), "parse written archive");
+    check(parser.get_index().entry_count() == samples.size(), "entry count");
+
+    for (const auto& sample : samples) {
+        unpaker::EntryId id = parser.find(sample.path);
+        check(id != unpaker::INVALID_ENTRY_ID, "find " + sample.path);
+        if (id == unpaker::INVALID_ENTRY_ID) continue;
+
+        std::vector<uint8_t> data;
+        check(parser.extract_entry(id, data) && data == sample.data, "contents of " + sample.path);
+        check(parser.get_index().crc(id) == unpaker::crc32(sample.data.data(), sample.data.size()),
+              "CRC-32 of " + sample.path);
+        check(parser.get_index().preload_size(id) == sample.preload, "preload size of " + sample.path);
+    }
+
+    unpaker::SectionChecksumReport checksums = parser.verify_section_checksums();
+    check(checksums.present, "MD5 sections present");
+    check(checksums.chunks_checked > 0 && checksums.chunks_failed == 0, "archive MD5 chunks match");
+    check(checksums.failures.empty(), "tree and whole-file digests match");
+
+    check_rebuild(dir);
+
+    fs::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "VPK round trip passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,218 @@
+// unPAKer - Game Resource Archive Extractor
+// Copyright (c) 2026 mxtherfxcker and contributors
+// Licensed under MIT License
+
+// Encodes v1 and v2 VPK directory trees by hand, independently of VpkWriter, and checks that
+// PakParser turns both into the same DirectoryEntry tree as the golden listing below, with every
+// entry's bytes readable from its preload, data volume or the directory file itself.
+
+#include "pak_parser.hpp"
+#include "vpk_format.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace vpk = unpaker::parsers::vpk;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+struct Entry {
+    std::string extension;
+    std::string directory;
+    std::string name;
+    uint32_t crc;
+    std::string preload;
+    uint16_t archive_index;
+    uint32_t offset;
+    std::string data;
+};
+
+// Entries grouped the way the tree nests them: extension, then directory, then file
+const std::vector<Entry> ENTRIES = {
+    {"txt", "scripts", "items", 0x11111111, "", 0, 0, "item list"},
+    {"txt", "scripts", "game", 0x22222222, "", 0, 9, "game rules"},
+    {"txt", vpk::EMPTY_NAME, "root", 0x33333333, "", 1, 0, "top level"},
+    {"vmt", "materials/models", "hero", 0x44444444, "ABCD", 0, 19, "shader"},
+    {vpk::EMPTY_NAME, "bin", "noext", 0x55555555, "", 1, 9, "plain"},
+    {"wav", "sound/ambient/deep", "wind", 0x66666666, "", static_cast<uint16_t>(vpk::EMBEDDED_ARCHIVE_INDEX), 0, "whoosh"},
+    {"wav", "sound/ambient/deep", "only_preload", 0x77777777, "PRE", 0, 0, ""},
+};
+
+const char* const GOLDEN =
+    "bin/\n"
+    "  noext size=5 crc=55555555 volume=1 offset=9\n"
+    "materials/\n"
+    "  models/\n"
+    "    hero.vmt size=10 crc=44444444 volume=0 offset=19\n"
+    "root.txt size=9 crc=33333333 volume=1 offset=0\n"
+    "scripts/\n"
+    "  game.txt size=10 crc=22222222 volume=0 offset=9\n"
+    "  items.txt size=9 crc=11111111 volume=0 offset=0\n"
+    "sound/\n"
+    "  ambient/\n"
+    "    deep/\n"
+    "      only_preload.wav size=3 crc=77777777 volume=0 offset=0\n"
+    "      wind.wav size=6 crc=66666666 volume=32767 offset=0\n";
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put_cstring(std::string& out, const std::string& text) {
+    out += text;
+    out += '\0';
+}
+
+std::string encode_tree() {
+    std::string tree;
+    size_t i = 0;
+    while (i < ENTRIES.size()) {
+        const std::string& extension = ENTRIES[i].extension;
+        put_cstring(tree, extension);
+        while (i < ENTRIES.size() && ENTRIES[i].extension == extension) {
+            const std::string& directory = ENTRIES[i].directory;
+            put_cstring(tree, directory);
+            for (; i < ENTRIES.size() && ENTRIES[i].extension == extension && ENTRIES[i].directory == directory; ++i) {
+                const Entry& entry = ENTRIES[i];
+                put_cstring(tree, entry.name);
+                put(tree, entry.crc);
+                put(tree, static_cast<uint16_t>(entry.preload.size()));
+                put(tree, entry.archive_index);
+                put(tree, entry.offset);
+                put(tree, static_cast<uint32_t>(entry.data.size()));
+                put(tree, vpk::ENTRY_TERMINATOR);
+                tree += entry.preload;
+            }
+            put_cstring(tree, "");
+        }
+        put_cstring(tree, "");
+    }
+    put_cstring(tree, "");
+    return tree;
+}
+
+void write_file(const fs::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Volumes hold each entry's data at its offset; embedded data follows the tree
+void write_archive(const fs::path& dir_file, uint32_t version) {
+    std::string tree = encode_tree();
+    std::string embedded;
+    std::string volumes[2];
+    for (const Entry& entry : ENTRIES) {
+        std::string& target = entry.archive_index == vpk::EMBEDDED_ARCHIVE_INDEX ? embedded : volumes[entry.archive_index];
+        if (target.size() < entry.offset + entry.data.size()) target.resize(entry.offset + entry.data.size());
+        target.replace(entry.offset, entry.data.size(), entry.data);
+    }
+
+    std::string file;
+    put(file, vpk::SIGNATURE);
+    put(file, version);
+    put(file, static_cast<uint32_t>(tree.size()));
+    if (version == 2) {
+        put(file, static_cast<uint32_t>(embedded.size()));
+        put(file, uint32_t{0});
+        put(file, uint32_t{0});
+        put(file, uint32_t{0});
+    }
+    write_file(dir_file, file + tree + embedded);
+
+    std::string prefix = dir_file.stem().string();
+    prefix.erase(prefix.size() - 4);
+    for (int v = 0; v < 2; ++v) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "_%03d.vpk", v);
+        write_file(dir_file.parent_path() / (prefix + name), volumes[v]);
+    }
+}
+
+void render(const unpaker::DirectoryEntry& dir, const std::string& indent, std::string& out) {
+    // Files and subdirectories interleaved by name, as a directory listing would show them
+    std::vector<std::pair<std::string, std::string>> lines;
+    for (const auto& sub : dir.subdirectories) {
+        std::string text = indent + sub->name + "/\n";
+        render(*sub, indent + "  ", text);
+        lines.push_back({sub->name, text});
+        check(sub->parent.get() == &dir, "parent link of " + sub->name);
+    }
+    for (const auto& file : dir.files) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%s%s size=%u crc=%08x volume=%u offset=%llu\n", indent.c_str(),
+                      file->name.c_str(), file->size, file->crc, file->archive_index,
+                      static_cast<unsigned long long>(file->offset));
+        lines.push_back({file->name, line});
+    }
+    std::sort(lines.begin(), lines.end());
+    for (const auto& line : lines) out += line.second;
+}
+
+void check_archive(const fs::path& dir_file, uint32_t version) {
+    const std::string label = "v" + std::to_string(version) + ": ";
+    write_archive(dir_file, version);
+
+    unpaker::PakParser parser(dir_file);
+    parser.set_index_cache_enabled(false);
+    check(parser.parse(), label + "parse");
+
+    auto root = parser.get_root();
+    check(root != nullptr, label + "tree built");
+    if (!root) return;
+
+    std::string tree;
+    render(*root, "", tree);
+    check(tree == GOLDEN, label + "tree matches the golden listing");
+    if (tree != GOLDEN) {
+        std::cerr << tree;
+    }
+
+    for (const Entry& entry : ENTRIES) {
+        std::string path;
+        if (entry.directory != vpk::EMPTY_NAME) path = entry.directory + "/";
+        path += entry.name;
+        if (entry.extension != vpk::EMPTY_NAME) path += "." + entry.extension;
+
+        std::vector<uint8_t> data;
+        unpaker::EntryId id = parser.find(path);
+        bool read = id != unpaker::INVALID_ENTRY_ID && parser.extract_entry(id, data);
+        std::string expected = entry.preload + entry.data;
+        check(read && std::string(data.begin(), data.end()) == expected, label + "contents of " + path);
+    }
+}
+
+} // namespace
+
+int main() {
+    fs::path dir = fs::temp_directory_path() / "unpaker_vpk_tree";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+
+    check_archive(dir / "v1_dir.vpk", 1);
+    check_archive(dir / "v2_dir.vpk", 2);
+
+    fs::remove_all(dir, ec);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "VPK tree golden check passed" << std::endl;
+    return 0;
+}